@@ -0,0 +1,166 @@
+/*
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "dbus-sdr/entityassociations.hpp"
+
+#include <boost/algorithm/string/predicate.hpp>
+
+namespace dynamic_sensors::ipmi::entity
+{
+
+static constexpr const char* configurationPrefix =
+    "xyz.openbmc_project.Configuration.";
+
+// Fans can have multiple configuration interfaces, these are the ones with
+// the entity
+static constexpr const char* fanConfigurations[] = {
+    "xyz.openbmc_project.Configuration.AspeedFan",
+    "xyz.openbmc_project.Configuration.I2CFan",
+    "xyz.openbmc_project.Configuration.NuvotonFan"};
+
+static bool isEntityInterface(const std::string& interface)
+{
+    return interface == EntityAssociations::ipmiDecorator ||
+           boost::algorithm::starts_with(interface, configurationPrefix);
+}
+
+// Integer fields added via Entity-Manager json are uint64_ts
+static void applyProperties(const PropertyMap& properties,
+                            EntityProperties& entity)
+{
+    auto entityId = properties.find("EntityId");
+    if (entityId != properties.end())
+    {
+        if (const uint64_t* value = std::get_if<uint64_t>(&entityId->second))
+        {
+            entity.entityId = static_cast<uint8_t>(*value);
+        }
+    }
+    auto entityInstance = properties.find("EntityInstance");
+    if (entityInstance != properties.end())
+    {
+        if (const uint64_t* value =
+                std::get_if<uint64_t>(&entityInstance->second))
+        {
+            entity.entityInstance = static_cast<uint8_t>(*value);
+        }
+    }
+}
+
+static void setEntity(const EntityProperties& entity, uint8_t& entityId,
+                      uint8_t& entityInstance)
+{
+    if (entity.entityId)
+    {
+        entityId = *entity.entityId;
+    }
+    if (entity.entityInstance)
+    {
+        entityInstance = *entity.entityInstance;
+    }
+}
+
+void EntityAssociations::addInterfaces(const std::string& path,
+                                       const InterfaceMap& interfaces)
+{
+    for (const auto& [interface, properties] : interfaces)
+    {
+        if (!isEntityInterface(interface))
+        {
+            continue;
+        }
+        EntityProperties entity;
+        applyProperties(properties, entity);
+        objects[path][interface] = entity;
+    }
+}
+
+void EntityAssociations::removeInterfaces(
+    const std::string& path, const std::vector<std::string>& interfaces)
+{
+    auto object = objects.find(path);
+    if (object == objects.end())
+    {
+        return;
+    }
+    for (const auto& interface : interfaces)
+    {
+        object->second.erase(interface);
+    }
+    if (object->second.empty())
+    {
+        objects.erase(object);
+    }
+}
+
+void EntityAssociations::updateProperties(const std::string& path,
+                                          const std::string& interface,
+                                          const PropertyMap& changed)
+{
+    auto object = objects.find(path);
+    if (object == objects.end())
+    {
+        return;
+    }
+    auto entity = object->second.find(interface);
+    if (entity != object->second.end())
+    {
+        applyProperties(changed, entity->second);
+    }
+}
+
+void EntityAssociations::lookup(const std::string& board,
+                                const std::string& sensorName,
+                                uint8_t& entityId,
+                                uint8_t& entityInstance) const
+{
+    auto boardObject = objects.find(board);
+    if (boardObject != objects.end())
+    {
+        auto decorator = boardObject->second.find(ipmiDecorator);
+        if (decorator != boardObject->second.end())
+        {
+            setEntity(decorator->second, entityId, entityInstance);
+        }
+    }
+
+    // A sensor's own configuration overrides the board
+    auto sensorObject = objects.find(board + "/" + sensorName);
+    if (sensorObject == objects.end())
+    {
+        return;
+    }
+    const EntityObject& sensor = sensorObject->second;
+    for (const char* fan : fanConfigurations)
+    {
+        auto configuration = sensor.find(fan);
+        if (configuration != sensor.end())
+        {
+            setEntity(configuration->second, entityId, entityInstance);
+            return;
+        }
+    }
+    for (const auto& [interface, entity] : sensor)
+    {
+        if (interface != ipmiDecorator)
+        {
+            setEntity(entity, entityId, entityInstance);
+            return;
+        }
+    }
+}
+
+} // namespace dynamic_sensors::ipmi::entity
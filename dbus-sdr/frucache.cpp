@@ -0,0 +1,118 @@
+/*
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "dbus-sdr/frucache.hpp"
+
+#include <utility>
+
+namespace dynamic_sensors::ipmi::fru
+{
+
+std::vector<uint8_t>& FruImage::writable()
+{
+    if (data.use_count() > 1)
+    {
+        data = std::make_shared<std::vector<uint8_t>>(*data);
+    }
+    return *data;
+}
+
+FruCache::FruCache(size_t capacity) : maxImages(capacity == 0 ? 1 : capacity)
+{
+}
+
+FruImage* FruCache::find(uint8_t devId)
+{
+    if (!cached[devId])
+    {
+        return nullptr;
+    }
+    lru.splice(lru.begin(), lru, index[devId]);
+    return &*index[devId];
+}
+
+FruImage* FruCache::peek(uint8_t devId)
+{
+    return cached[devId] ? &*index[devId] : nullptr;
+}
+
+FruImage& FruCache::insert(uint8_t devId, uint8_t bus, uint8_t addr,
+                           std::vector<uint8_t>&& data)
+{
+    if (cached[devId])
+    {
+        lru.erase(index[devId]);
+    }
+    lru.push_front(FruImage{
+        devId, bus, addr, false,
+        std::make_shared<std::vector<uint8_t>>(std::move(data))});
+    index[devId] = lru.begin();
+    cached[devId] = true;
+    evict();
+    return lru.front();
+}
+
+void FruCache::erase(uint8_t devId)
+{
+    if (cached[devId])
+    {
+        lru.erase(index[devId]);
+        cached[devId] = false;
+    }
+}
+
+void FruCache::eraseDevice(uint8_t bus, uint8_t addr)
+{
+    for (auto it = lru.begin(); it != lru.end();)
+    {
+        if (it->bus == bus && it->addr == addr)
+        {
+            cached[it->devId] = false;
+            it = lru.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void FruCache::clear()
+{
+    lru.clear();
+    cached.fill(false);
+}
+
+void FruCache::evict()
+{
+    // The newest image is at the front and is kept even when all the
+    // others are dirty
+    for (auto it = lru.end(); lru.size() > maxImages && it != lru.begin();)
+    {
+        --it;
+        if (it == lru.begin())
+        {
+            break;
+        }
+        if (!it->dirty)
+        {
+            cached[it->devId] = false;
+            it = lru.erase(it);
+        }
+    }
+}
+
+} // namespace dynamic_sensors::ipmi::fru
@@ -16,9 +16,13 @@
 
 #include "dbus-sdr/sdrutils.hpp"
 
+#include <chrono>
+#include <string_view>
+
 #ifdef FEATURE_HYBRID_SENSORS
 
 #include <ipmid/utils.hpp>
+#include <unordered_map>
 namespace ipmi
 {
 namespace sensor
@@ -142,53 +146,193 @@ uint16_t getSensorSubtree(std::shared_ptr<SensorSubTree>& subtree)
     return sensorUpdatedIndex;
 }
 
-bool getSensorNumMap(std::shared_ptr<SensorNumMap>& sensorNumMap)
+// The last index built, and the sensor tree it was built from. The sensor
+// tree is dropped when sensors are added or removed.
+static std::shared_ptr<SensorIndex> sensorIndexPtr;
+static std::weak_ptr<SensorSubTree> indexedSensorTree;
+
+bool getSensorIndex(std::shared_ptr<SensorIndex>& sensorIndex)
 {
-    static std::shared_ptr<SensorNumMap> sensorNumMapPtr;
-    bool sensorNumMapUpated = false;
     static uint16_t prevSensorUpdatedIndex = 0;
     std::shared_ptr<SensorSubTree> sensorTree;
     uint16_t curSensorUpdatedIndex = details::getSensorSubtree(sensorTree);
     if (!sensorTree)
     {
-        return sensorNumMapUpated;
+        return false;
     }
 
-    if ((curSensorUpdatedIndex == prevSensorUpdatedIndex) && sensorNumMapPtr)
+    if ((curSensorUpdatedIndex == prevSensorUpdatedIndex) && sensorIndexPtr)
     {
-        sensorNumMap = sensorNumMapPtr;
-        return sensorNumMapUpated;
+        sensorIndex = sensorIndexPtr;
+        return false;
     }
-    prevSensorUpdatedIndex = curSensorUpdatedIndex;
-
-    sensorNumMapPtr = std::make_shared<SensorNumMap>();
 
-    uint16_t sensorNum = 0;
-    uint16_t sensorIndex = 0;
-    for (const auto& sensor : *sensorTree)
+    auto newIndex = std::make_shared<SensorIndex>();
+    newIndex->reserve(sensorTree->size());
+    for (const auto& [path, services] : *sensorTree)
     {
-        sensorNumMapPtr->insert(
-            SensorNumMap::value_type(sensorNum, sensor.first));
-        sensorIndex++;
-        if (sensorIndex == maxSensorsPerLUN)
+        SensorIndexEntry* entry;
+        if (services.empty())
+        {
+            entry = &newIndex->append(path, std::string(), {});
+        }
+        else
         {
-            sensorIndex = lun1Sensor0;
+            // Handlers have always used the first service owning the sensor
+            entry = &newIndex->append(path, services.begin()->first,
+                                      services.begin()->second);
         }
-        else if (sensorIndex == (lun1Sensor0 | maxSensorsPerLUN))
+
+        // Sensors that stay keep the assert history the signals recorded,
+        // the rest of the threshold state is read again on first use
+        const SensorIndexEntry* oldEntry =
+            sensorIndexPtr ? sensorIndexPtr->find(std::string_view(path))
+                           : nullptr;
+        if (oldEntry != nullptr && oldEntry->service == entry->service)
         {
-            // Skip assigning LUN 0x2 any sensors
-            sensorIndex = lun3Sensor0;
+            entry->attributes = oldEntry->attributes;
+            entry->thresholds.asserted = oldEntry->thresholds.asserted;
         }
-        else if (sensorIndex == (lun3Sensor0 | maxSensorsPerLUN))
+
+#ifdef FEATURE_HYBRID_SENSORS
+        auto staticSensor = findStaticSensor(path);
+        if (staticSensor != ipmi::sensor::sensors.end())
         {
-            // this is an error, too many IPMI sensors
-            throw std::out_of_range("Maximum number of IPMI sensors exceeded.");
+            entry->staticSensor = static_cast<uint16_t>(
+                staticSensor - ipmi::sensor::sensors.begin());
         }
-        sensorNum = sensorIndex;
+#endif
     }
-    sensorNumMap = sensorNumMapPtr;
-    sensorNumMapUpated = true;
-    return sensorNumMapUpated;
+
+    prevSensorUpdatedIndex = curSensorUpdatedIndex;
+    sensorIndexPtr = std::move(newIndex);
+    indexedSensorTree = sensorTree;
+    sensorIndex = sensorIndexPtr;
+    return true;
+}
+
+std::shared_ptr<SensorIndex> getCurrentSensorIndex()
+{
+    if (indexedSensorTree.expired())
+    {
+        return nullptr;
+    }
+    return sensorIndexPtr;
+}
+
+const dynamic_sensors::ipmi::entity::EntityAssociations&
+    getEntityAssociations()
+{
+    using dynamic_sensors::ipmi::entity::InterfaceMap;
+    using dynamic_sensors::ipmi::entity::PropertyMap;
+    namespace rules = sdbusplus::bus::match::rules;
+
+    static constexpr const char* entityManagerService =
+        "xyz.openbmc_project.EntityManager";
+    // Entity-Manager is not asked again for this long after a failed read
+    static constexpr auto retryInterval = std::chrono::seconds(30);
+    static dynamic_sensors::ipmi::entity::EntityAssociations associations;
+    // Read again after Entity-Manager restarts
+    static bool loaded = false;
+    static std::chrono::steady_clock::time_point retryAfter;
+    std::shared_ptr<sdbusplus::asio::connection> dbus = getSdBus();
+
+    // A signal that can't be read leaves the table behind, so it is read
+    // again on the next use
+    static sdbusplus::bus::match::match entitiesAdded(
+        *dbus, rules::interfacesAdded() + rules::sender(entityManagerService),
+        [](sdbusplus::message::message& m) {
+            sdbusplus::message::object_path path;
+            InterfaceMap interfaces;
+            try
+            {
+                m.read(path, interfaces);
+            }
+            catch (const sdbusplus::exception_t& e)
+            {
+                loaded = false;
+                return;
+            }
+            associations.addInterfaces(path.str, interfaces);
+        });
+
+    static sdbusplus::bus::match::match entitiesRemoved(
+        *dbus,
+        rules::interfacesRemoved() + rules::sender(entityManagerService),
+        [](sdbusplus::message::message& m) {
+            sdbusplus::message::object_path path;
+            std::vector<std::string> interfaces;
+            try
+            {
+                m.read(path, interfaces);
+            }
+            catch (const sdbusplus::exception_t& e)
+            {
+                loaded = false;
+                return;
+            }
+            associations.removeInterfaces(path.str, interfaces);
+        });
+
+    static sdbusplus::bus::match::match entitiesChanged(
+        *dbus,
+        rules::type::signal() + rules::member("PropertiesChanged") +
+            rules::interface("org.freedesktop.DBus.Properties") +
+            rules::sender(entityManagerService),
+        [](sdbusplus::message::message& m) {
+            std::string interface;
+            PropertyMap changed;
+            try
+            {
+                m.read(interface, changed);
+            }
+            catch (const sdbusplus::exception_t& e)
+            {
+                loaded = false;
+                return;
+            }
+            associations.updateProperties(m.get_path(), interface, changed);
+        });
+
+    static sdbusplus::bus::match::match entityManagerOwner(
+        *dbus, rules::nameOwnerChanged(entityManagerService),
+        [](sdbusplus::message::message& m) {
+            associations.clear();
+            loaded = false;
+            retryAfter = {};
+        });
+
+    if (loaded || std::chrono::steady_clock::now() < retryAfter)
+    {
+        return associations;
+    }
+
+    boost::container::flat_map<sdbusplus::message::object_path, InterfaceMap>
+        entities;
+    try
+    {
+        auto getObjects = dbus->new_method_call(
+            entityManagerService, "/", "org.freedesktop.DBus.ObjectManager",
+            "GetManagedObjects");
+        auto reply = dbus->call(getObjects);
+        reply.read(entities);
+    }
+    catch (const std::exception& e)
+    {
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Failed to read the Entity-Manager objects",
+            phosphor::logging::entry("WHAT=%s", e.what()));
+        retryAfter = std::chrono::steady_clock::now() + retryInterval;
+        return associations;
+    }
+
+    associations.clear();
+    for (const auto& [path, interfaces] : entities)
+    {
+        associations.addInterfaces(path.str, interfaces);
+    }
+    loaded = true;
+    return associations;
 }
 } // namespace details
 
@@ -210,99 +354,76 @@ bool getSensorSubtree(SensorSubTree& subtree)
 ipmi::sensor::IdInfoMap::const_iterator
     findStaticSensor(const std::string& path)
 {
-    return std::find_if(
-        ipmi::sensor::sensors.begin(), ipmi::sensor::sensors.end(),
-        [&path](const ipmi::sensor::IdInfoMap::value_type& findSensor) {
-            return findSensor.second.sensorPath == path;
-        });
-}
-#endif
+    using Iterator = ipmi::sensor::IdInfoMap::const_iterator;
+    // The static sensors never change, so their paths are indexed once. The
+    // first sensor with a path is kept, as the linear search found it.
+    static const auto index = []() {
+        std::unordered_map<std::string_view, Iterator> index;
+        for (Iterator sensor = ipmi::sensor::sensors.begin();
+             sensor != ipmi::sensor::sensors.end(); ++sensor)
+        {
+            index.emplace(sensor->second.sensorPath, sensor);
+        }
+        return index;
+    }();
 
-std::string getSensorTypeStringFromPath(const std::string& path)
-{
-    // get sensor type string from path, path is defined as
-    // /xyz/openbmc_project/sensors/<type>/label
-    size_t typeEnd = path.rfind("/");
-    if (typeEnd == std::string::npos)
+    auto findSensor = index.find(path);
+    if (findSensor == index.end())
     {
-        return path;
+        return ipmi::sensor::sensors.end();
     }
-    size_t typeStart = path.rfind("/", typeEnd - 1);
-    if (typeStart == std::string::npos)
-    {
-        return path;
-    }
-    // Start at the character after the '/'
-    typeStart++;
-    return path.substr(typeStart, typeEnd - typeStart);
+    return findSensor->second;
 }
 
-uint8_t getSensorTypeFromPath(const std::string& path)
+ipmi::sensor::IdInfoMap::const_iterator
+    findStaticSensor(const SensorIndexEntry& entry)
 {
-    uint8_t sensorType = 0;
-    std::string type = getSensorTypeStringFromPath(path);
-    auto findSensor = sensorTypes.find(type.c_str());
-    if (findSensor != sensorTypes.end())
+    if (entry.staticSensor == noStaticSensor)
     {
-        sensorType =
-            static_cast<uint8_t>(std::get<sensorTypeCodes>(findSensor->second));
-    } // else default 0x0 RESERVED
-
-    return sensorType;
+        return ipmi::sensor::sensors.end();
+    }
+    return ipmi::sensor::sensors.nth(entry.staticSensor);
 }
+#endif
 
 uint16_t getSensorNumberFromPath(const std::string& path)
 {
-    std::shared_ptr<SensorNumMap> sensorNumMapPtr;
-    details::getSensorNumMap(sensorNumMapPtr);
-    if (!sensorNumMapPtr)
+    std::shared_ptr<SensorIndex> sensorIndexPtr;
+    details::getSensorIndex(sensorIndexPtr);
+    if (!sensorIndexPtr)
     {
         return invalidSensorNumber;
     }
 
-    try
+    const SensorIndexEntry* entry = sensorIndexPtr->find(path);
+    if (entry == nullptr)
     {
-        return sensorNumMapPtr->right.at(path);
-    }
-    catch (std::out_of_range& e)
-    {
-        phosphor::logging::log<phosphor::logging::level::ERR>(e.what());
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Sensor path not found in the sensor index",
+            phosphor::logging::entry("PATH=%s", path.c_str()));
         return invalidSensorNumber;
     }
-}
-
-uint8_t getSensorEventTypeFromPath(const std::string& path)
-{
-    uint8_t sensorEventType = 0;
-    std::string type = getSensorTypeStringFromPath(path);
-    auto findSensor = sensorTypes.find(type.c_str());
-    if (findSensor != sensorTypes.end())
-    {
-        sensorEventType = static_cast<uint8_t>(
-            std::get<sensorEventTypeCodes>(findSensor->second));
-    }
-
-    return sensorEventType;
+    return entry->sensorNumber;
 }
 
 std::string getPathFromSensorNumber(uint16_t sensorNum)
 {
-    std::shared_ptr<SensorNumMap> sensorNumMapPtr;
-    details::getSensorNumMap(sensorNumMapPtr);
-    if (!sensorNumMapPtr)
+    std::shared_ptr<SensorIndex> sensorIndexPtr;
+    details::getSensorIndex(sensorIndexPtr);
+    if (!sensorIndexPtr)
     {
         return std::string();
     }
 
-    try
+    const SensorIndexEntry* entry = sensorIndexPtr->find(sensorNum);
+    if (entry == nullptr)
     {
-        return sensorNumMapPtr->left.at(sensorNum);
-    }
-    catch (std::out_of_range& e)
-    {
-        phosphor::logging::log<phosphor::logging::level::ERR>(e.what());
+        phosphor::logging::log<phosphor::logging::level::ERR>(
+            "Sensor number not found in the sensor index",
+            phosphor::logging::entry("SENSOR=%u", sensorNum));
         return std::string();
     }
+    return entry->path;
 }
 
 namespace ipmi
@@ -449,74 +570,12 @@ void updateIpmiFromAssociation(const std::string& path,
             continue;
         }
 
-        // the endpoint is the board entry provided by
-        // Entity-Manager. so let's grab its properties if it has
-        // the right interface.
-
-        // just try grabbing the properties first.
-        std::map<std::string, Value> ipmiProperties =
-            getEntityManagerProperties(
-                endpoint.c_str(),
-                "xyz.openbmc_project.Inventory.Decorator.Ipmi");
-
-        auto entityIdProp = ipmiProperties.find("EntityId");
-        auto entityInstanceProp = ipmiProperties.find("EntityInstance");
-        if (entityIdProp != ipmiProperties.end())
-        {
-            entityId =
-                static_cast<uint8_t>(std::get<uint64_t>(entityIdProp->second));
-        }
-        if (entityInstanceProp != ipmiProperties.end())
-        {
-            entityInstance = static_cast<uint8_t>(
-                std::get<uint64_t>(entityInstanceProp->second));
-        }
-
-        // Now check the entity-manager entry for this sensor to see
-        // if it has its own value and use that instead.
-        //
-        // In theory, checking this first saves us from checking
-        // both, except in most use-cases identified, there won't be
-        // a per sensor override, so we need to always check both.
+        // the endpoint is the board entry provided by Entity-Manager,
+        // and the sensor may have its own configuration under it that
+        // overrides the board's entity.
         std::string sensorNameFromPath = fs::path(path).filename();
-
-        std::string sensorConfigPath = endpoint + "/" + sensorNameFromPath;
-
-        // Download the interfaces for the sensor from
-        // Entity-Manager to find the name of the configuration
-        // interface.
-        std::map<std::string, std::vector<std::string>>
-            sensorInterfacesResponse =
-                getObjectInterfaces(sensorConfigPath.c_str());
-
-        const std::string* configurationInterface =
-            getSensorConfigurationInterface(sensorInterfacesResponse);
-
-        // We didnt' find a configuration interface for this sensor, but we
-        // followed the Association property to get here, so we're done
-        // searching.
-        if (!configurationInterface)
-        {
-            break;
-        }
-
-        // We found a configuration interface.
-        std::map<std::string, Value> configurationProperties =
-            getEntityManagerProperties(sensorConfigPath.c_str(),
-                                       configurationInterface->c_str());
-
-        entityIdProp = configurationProperties.find("EntityId");
-        entityInstanceProp = configurationProperties.find("EntityInstance");
-        if (entityIdProp != configurationProperties.end())
-        {
-            entityId =
-                static_cast<uint8_t>(std::get<uint64_t>(entityIdProp->second));
-        }
-        if (entityInstanceProp != configurationProperties.end())
-        {
-            entityInstance = static_cast<uint8_t>(
-                std::get<uint64_t>(entityInstanceProp->second));
-        }
+        details::getEntityAssociations().lookup(endpoint, sensorNameFromPath,
+                                                entityId, entityInstance);
 
         // stop searching Association records.
         break;
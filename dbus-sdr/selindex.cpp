@@ -0,0 +1,426 @@
+/*
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "dbus-sdr/selindex.hpp"
+
+#include <fcntl.h>
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+namespace dynamic_sensors::ipmi::sel
+{
+
+static constexpr size_t readChunkSize = 64 * 1024;
+static constexpr uint32_t watchEvents =
+    IN_MODIFY | IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO;
+
+static bool isSELFile(std::string_view name, std::string_view prefix)
+{
+    return name.substr(0, prefix.size()) == prefix;
+}
+
+static bool byRecordID(const SELIndexEntry& entry, uint16_t recordID)
+{
+    return entry.recordID < recordID;
+}
+
+bool parseSELLine(std::string_view line, uint16_t& recordID,
+                  uint32_t& timestamp)
+{
+    // The record ID follows the timestamp and its spaces, up to the comma
+    size_t space = line.find(' ');
+    if (space == std::string_view::npos)
+    {
+        return false;
+    }
+    size_t pos = line.find_first_not_of(' ', space);
+    if (pos == std::string_view::npos)
+    {
+        return false;
+    }
+    uint32_t id = 0;
+    size_t start = pos;
+    for (; pos < line.size() && line[pos] >= '0' && line[pos] <= '9'; pos++)
+    {
+        id = id * 10 + (line[pos] - '0');
+        if (id > UINT16_MAX)
+        {
+            return false;
+        }
+    }
+    if (pos == start || pos == line.size() || line[pos] != ',')
+    {
+        return false;
+    }
+    recordID = static_cast<uint16_t>(id);
+
+    // Same fields as std::get_time() with "%Y-%m-%dT%H:%M:%S"
+    std::string stamp(line.substr(0, space));
+    std::tm timeStruct = {};
+    timestamp = invalidSELTimestamp;
+    if (std::sscanf(stamp.c_str(), "%4d-%2d-%2dT%2d:%2d:%2d",
+                    &timeStruct.tm_year, &timeStruct.tm_mon,
+                    &timeStruct.tm_mday, &timeStruct.tm_hour,
+                    &timeStruct.tm_min, &timeStruct.tm_sec) == 6)
+    {
+        timeStruct.tm_year -= 1900;
+        timeStruct.tm_mon -= 1;
+        timestamp = std::mktime(&timeStruct);
+    }
+    return true;
+}
+
+SELIndex::SELIndex(const std::filesystem::path& dir,
+                   const std::string& prefix) :
+    dir(dir),
+    prefix(prefix)
+{
+    inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd < 0)
+    {
+        return;
+    }
+    if (inotify_add_watch(inotifyFd, dir.c_str(), watchEvents) < 0)
+    {
+        close(inotifyFd);
+        inotifyFd = -1;
+    }
+}
+
+SELIndex::~SELIndex()
+{
+    if (inotifyFd >= 0)
+    {
+        close(inotifyFd);
+    }
+}
+
+void SELIndex::refresh()
+{
+    if (inotifyFd < 0)
+    {
+        rebuild();
+        return;
+    }
+
+    bool liveChanged = false;
+    if (readEvents(liveChanged))
+    {
+        stale = true;
+    }
+    if (stale)
+    {
+        rebuild();
+    }
+    else if (liveChanged)
+    {
+        appendLive();
+    }
+}
+
+void SELIndex::invalidate()
+{
+    stale = true;
+    entries.clear();
+    logFiles.clear();
+    liveIndexed = 0;
+    haveLive = false;
+}
+
+const SELIndexEntry* SELIndex::find(uint16_t recordID) const
+{
+    auto found =
+        std::lower_bound(entries.begin(), entries.end(), recordID, byRecordID);
+    if (found == entries.end() || found->recordID != recordID)
+    {
+        return nullptr;
+    }
+    return &*found;
+}
+
+const SELIndexEntry* SELIndex::next(uint16_t recordID) const
+{
+    auto found = std::upper_bound(
+        entries.begin(), entries.end(), recordID,
+        [](uint16_t id, const SELIndexEntry& entry) {
+            return id < entry.recordID;
+        });
+    if (found == entries.end())
+    {
+        return nullptr;
+    }
+    return &*found;
+}
+
+bool SELIndex::read(const SELIndexEntry& entry, std::string& line) const
+{
+    if (entry.file >= logFiles.size())
+    {
+        return false;
+    }
+    int fd = open(logFiles[entry.file].c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return false;
+    }
+    line.resize(entry.length);
+    ssize_t len = pread(fd, line.data(), entry.length, entry.offset);
+    close(fd);
+    return len == static_cast<ssize_t>(entry.length);
+}
+
+uint64_t SELIndex::indexFile(uint16_t file, uint64_t offset,
+                             std::vector<SELIndexEntry>& found) const
+{
+    int fd = open(logFiles[file].c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        return offset;
+    }
+
+    std::vector<char> buffer(readChunkSize);
+    // Start of a line that continues in the next chunk
+    std::string partial;
+    uint64_t lineStart = offset;
+    uint64_t readPos = offset;
+    while (true)
+    {
+        ssize_t len = pread(fd, buffer.data(), buffer.size(), readPos);
+        if (len < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (len <= 0)
+        {
+            break;
+        }
+        readPos += len;
+
+        const char* cursor = buffer.data();
+        const char* end = cursor + len;
+        while (cursor < end)
+        {
+            const char* newline = static_cast<const char*>(
+                std::memchr(cursor, '\n', end - cursor));
+            if (newline == nullptr)
+            {
+                partial.append(cursor, end);
+                break;
+            }
+            partial.append(cursor, newline);
+
+            uint16_t recordID = 0;
+            uint32_t timestamp = invalidSELTimestamp;
+            if (partial.size() <= UINT32_MAX &&
+                parseSELLine(partial, recordID, timestamp))
+            {
+                found.push_back({recordID, file, timestamp, lineStart,
+                                 static_cast<uint32_t>(partial.size())});
+            }
+            lineStart += partial.size() + 1;
+            partial.clear();
+            cursor = newline + 1;
+        }
+    }
+    close(fd);
+    return lineStart;
+}
+
+void SELIndex::rebuild()
+{
+    invalidate();
+    stale = false;
+    updates++;
+
+    std::error_code ec;
+    std::filesystem::directory_iterator dirItr(dir, ec);
+    for (; !ec && dirItr != std::filesystem::directory_iterator();
+         dirItr.increment(ec))
+    {
+        if (isSELFile(dirItr->path().filename().native(), prefix))
+        {
+            logFiles.emplace_back(dirItr->path());
+        }
+    }
+    // As the log files rotate, they are appended with a ".#" that is higher
+    // for the older logs. Since we don't expect more than 10 log files, we
+    // can just sort the list to get them in order from newest to oldest
+    std::sort(logFiles.begin(), logFiles.end());
+    haveLive = !logFiles.empty() && logFiles.front().filename() == prefix;
+
+    // Oldest file first, so a record ID logged again after wrapping around
+    // ends up pointing at its newest line
+    std::vector<SELIndexEntry> found;
+    for (size_t file = logFiles.size(); file-- > 0;)
+    {
+        uint64_t end = indexFile(file, 0, found);
+        if (file == 0 && haveLive)
+        {
+            liveIndexed = end;
+        }
+    }
+    std::stable_sort(found.begin(), found.end(),
+                     [](const SELIndexEntry& a, const SELIndexEntry& b) {
+                         return a.recordID < b.recordID;
+                     });
+    for (const SELIndexEntry& entry : found)
+    {
+        if (!entries.empty() && entries.back().recordID == entry.recordID)
+        {
+            entries.back() = entry;
+        }
+        else
+        {
+            entries.push_back(entry);
+        }
+    }
+    findEnds();
+}
+
+void SELIndex::appendLive()
+{
+    struct stat st;
+    if (!haveLive || stat(logFiles.front().c_str(), &st) < 0 ||
+        static_cast<uint64_t>(st.st_size) < liveIndexed)
+    {
+        // Gone or truncated under us
+        rebuild();
+        return;
+    }
+
+    std::vector<SELIndexEntry> found;
+    liveIndexed = indexFile(0, liveIndexed, found);
+    if (!found.empty())
+    {
+        updates++;
+    }
+    bool oldestLogged = false;
+    for (const SELIndexEntry& entry : found)
+    {
+        oldestLogged |= entry.recordID == oldestID;
+        // New records normally carry the highest ID, so this is an append
+        if (entries.empty() || entries.back().recordID < entry.recordID)
+        {
+            entries.push_back(entry);
+            continue;
+        }
+        auto pos = std::lower_bound(entries.begin(), entries.end(),
+                                    entry.recordID, byRecordID);
+        if (pos != entries.end() && pos->recordID == entry.recordID)
+        {
+            *pos = entry;
+        }
+        else
+        {
+            entries.insert(pos, entry);
+        }
+    }
+    if (oldestLogged || entries.size() == found.size())
+    {
+        findEnds();
+    }
+    else if (!found.empty())
+    {
+        newestID = found.back().recordID;
+    }
+    if (appendHandler)
+    {
+        for (const SELIndexEntry& entry : found)
+        {
+            appendHandler(entry);
+        }
+    }
+}
+
+void SELIndex::findEnds()
+{
+    // Files are numbered newest first, lines are in the order logged
+    const SELIndexEntry* oldest = nullptr;
+    const SELIndexEntry* newest = nullptr;
+    for (const SELIndexEntry& entry : entries)
+    {
+        if (oldest == nullptr || entry.file > oldest->file ||
+            (entry.file == oldest->file && entry.offset < oldest->offset))
+        {
+            oldest = &entry;
+        }
+        if (newest == nullptr || entry.file < newest->file ||
+            (entry.file == newest->file && entry.offset > newest->offset))
+        {
+            newest = &entry;
+        }
+    }
+    oldestID = oldest == nullptr ? 0 : oldest->recordID;
+    newestID = newest == nullptr ? 0 : newest->recordID;
+}
+
+bool SELIndex::readEvents(bool& liveChanged)
+{
+    alignas(struct inotify_event) char buffer[4096];
+    bool needRebuild = false;
+    while (true)
+    {
+        ssize_t len = ::read(inotifyFd, buffer, sizeof(buffer));
+        if (len < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (len <= 0)
+        {
+            // EAGAIN once drained, anything else leaves us unsure
+            if (len == 0 || errno != EAGAIN)
+            {
+                needRebuild = true;
+            }
+            break;
+        }
+
+        for (char* pos = buffer; pos < buffer + len;)
+        {
+            auto event = reinterpret_cast<const struct inotify_event*>(pos);
+            pos += sizeof(struct inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW)
+            {
+                needRebuild = true;
+                continue;
+            }
+            if (event->len == 0 || !isSELFile(event->name, prefix))
+            {
+                continue;
+            }
+            if (event->mask == IN_MODIFY && prefix == event->name)
+            {
+                liveChanged = true;
+            }
+            else
+            {
+                // Rotated, created, removed, or a write to a rotated file
+                needRebuild = true;
+            }
+        }
+    }
+    return needRebuild;
+}
+
+} // namespace dynamic_sensors::ipmi::sel
@@ -0,0 +1,272 @@
+/*
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "dbus-sdr/seljournal.hpp"
+
+#include "dbus-sdr/selindex.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <stdexcept>
+#include <system_error>
+
+namespace dynamic_sensors::ipmi::sel
+{
+
+static constexpr uint32_t journalMagic = 0x4c455349; // "ISEL"
+static constexpr uint16_t journalVersion = 2;
+// Record IDs run from 1 to 0xFFFE, 0x0000 and 0xFFFF are first/last entry
+static constexpr uint16_t firstRecordID = 0x0001;
+static constexpr uint16_t lastRecordID = 0xFFFE;
+static constexpr uint32_t recordIDCount = lastRecordID - firstRecordID + 1;
+
+struct SELJournal::Header
+{
+    uint32_t magic;
+    uint16_t version;
+    uint16_t recordSize;
+    uint32_t capacity;
+    uint32_t first; // ring slot of the oldest record
+    uint32_t count;
+    uint32_t addTimestamp;
+    uint32_t eraseTimestamp;
+    uint16_t nextRecordID;
+    uint16_t textRecordID;
+    uint8_t overflow;
+    uint8_t reserved[3];
+};
+
+std::array<uint8_t, selRecordContentSize>
+    systemEventContent(uint32_t timestamp, uint16_t generatorID,
+                       uint8_t evmRev, uint8_t sensorType, uint8_t sensorNum,
+                       uint8_t eventType,
+                       const std::array<uint8_t, 3>& eventData)
+{
+    // Multi-byte fields are little endian
+    return {static_cast<uint8_t>(timestamp),
+            static_cast<uint8_t>(timestamp >> 8),
+            static_cast<uint8_t>(timestamp >> 16),
+            static_cast<uint8_t>(timestamp >> 24),
+            static_cast<uint8_t>(generatorID),
+            static_cast<uint8_t>(generatorID >> 8),
+            evmRev,
+            sensorType,
+            sensorNum,
+            eventType,
+            eventData[0],
+            eventData[1],
+            eventData[2]};
+}
+
+SELJournal::SELJournal(const std::filesystem::path& path,
+                       uint32_t capacity)
+{
+    static_assert(sizeof(Header) == 36);
+
+    if (capacity == 0 || capacity >= recordIDCount)
+    {
+        throw std::invalid_argument("Invalid SEL journal capacity");
+    }
+
+    fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "Failed to open SEL journal");
+    }
+
+    mapSize = sizeof(Header) + capacity * sizeof(SELRecord);
+    struct stat st;
+    bool sized = fstat(fd, &st) == 0 &&
+                 static_cast<size_t>(st.st_size) == mapSize;
+    if (!sized && (ftruncate(fd, 0) < 0 || ftruncate(fd, mapSize) < 0))
+    {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(),
+                                "Failed to size SEL journal");
+    }
+
+    mapping =
+        mmap(nullptr, mapSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED)
+    {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(),
+                                "Failed to map SEL journal");
+    }
+    header = static_cast<Header*>(mapping);
+    records = reinterpret_cast<SELRecord*>(header + 1);
+
+    if (!sized || header->magic != journalMagic ||
+        header->version != journalVersion ||
+        header->recordSize != sizeof(SELRecord) ||
+        header->capacity != capacity || header->first >= capacity ||
+        header->count > capacity || header->nextRecordID < firstRecordID ||
+        header->nextRecordID > lastRecordID)
+    {
+        *header = Header{};
+        header->magic = journalMagic;
+        header->version = journalVersion;
+        header->recordSize = sizeof(SELRecord);
+        header->capacity = capacity;
+        header->addTimestamp = invalidSELTimestamp;
+        header->eraseTimestamp = invalidSELTimestamp;
+        header->nextRecordID = firstRecordID;
+        newJournal = true;
+    }
+}
+
+SELJournal::~SELJournal()
+{
+    munmap(mapping, mapSize);
+    close(fd);
+}
+
+uint16_t SELJournal::append(
+    uint8_t recordType,
+    const std::array<uint8_t, selRecordContentSize>& content,
+    uint32_t timestamp)
+{
+    uint32_t slot;
+    if (header->count < header->capacity)
+    {
+        slot = (header->first + header->count) % header->capacity;
+    }
+    else
+    {
+        slot = header->first;
+    }
+
+    // Fill in the record before the header points at it
+    SELRecord& record = records[slot];
+    uint16_t recordID = header->nextRecordID;
+    record.recordID = recordID;
+    record.recordType = recordType;
+    record.content = content;
+
+    if (header->count < header->capacity)
+    {
+        header->count++;
+    }
+    else
+    {
+        header->first = (header->first + 1) % header->capacity;
+        header->overflow = 1;
+    }
+    header->nextRecordID =
+        recordID == lastRecordID ? firstRecordID : recordID + 1;
+    header->addTimestamp = timestamp;
+    return recordID;
+}
+
+void SELJournal::erase(uint32_t timestamp)
+{
+    header->first = 0;
+    header->count = 0;
+    header->overflow = 0;
+    header->textRecordID = 0;
+    header->eraseTimestamp = timestamp;
+}
+
+bool SELJournal::position(uint16_t recordID, uint32_t& distance) const
+{
+    if (header->count == 0 || recordID < firstRecordID ||
+        recordID > lastRecordID)
+    {
+        return false;
+    }
+    uint16_t oldest = records[header->first].recordID;
+    distance = (recordID + recordIDCount - oldest) % recordIDCount;
+    return distance < header->count;
+}
+
+const SELRecord* SELJournal::at(uint32_t distance) const
+{
+    return &records[(header->first + distance) % header->capacity];
+}
+
+const SELRecord* SELJournal::find(uint16_t recordID) const
+{
+    uint32_t distance;
+    if (!position(recordID, distance))
+    {
+        return nullptr;
+    }
+    return at(distance);
+}
+
+const SELRecord* SELJournal::next(uint16_t recordID) const
+{
+    uint32_t distance;
+    if (!position(recordID, distance) || distance + 1 >= header->count)
+    {
+        return nullptr;
+    }
+    return at(distance + 1);
+}
+
+const SELRecord* SELJournal::first() const
+{
+    return header->count == 0 ? nullptr : at(0);
+}
+
+const SELRecord* SELJournal::last() const
+{
+    return header->count == 0 ? nullptr : at(header->count - 1);
+}
+
+uint32_t SELJournal::size() const
+{
+    return header->count;
+}
+
+uint32_t SELJournal::capacity() const
+{
+    return header->capacity;
+}
+
+uint32_t SELJournal::addTimestamp() const
+{
+    return header->addTimestamp;
+}
+
+uint32_t SELJournal::eraseTimestamp() const
+{
+    return header->eraseTimestamp;
+}
+
+uint16_t SELJournal::textRecordID() const
+{
+    return header->textRecordID;
+}
+
+void SELJournal::setTextRecordID(uint16_t recordID)
+{
+    header->textRecordID = recordID;
+}
+
+bool SELJournal::overflow() const
+{
+    return header->overflow != 0;
+}
+
+} // namespace dynamic_sensors::ipmi::sel
@@ -19,6 +19,7 @@
 #include "dbus-sdr/sdrutils.hpp"
 #include "dbus-sdr/sensorutils.hpp"
 #include "dbus-sdr/storagecommands.hpp"
+#include "user_channel/channel_layer.hpp"
 
 #include <algorithm>
 #include <array>
@@ -28,7 +29,9 @@
 #include <cmath>
 #include <cstring>
 #include <iostream>
+#include <limits>
 #include <ipmid/api.hpp>
+#include <ipmid/oemopenbmc.hpp>
 #include <ipmid/types.hpp>
 #include <ipmid/utils.hpp>
 #include <map>
@@ -38,6 +41,7 @@
 #include <sdbusplus/bus.hpp>
 #include <stdexcept>
 #include <string>
+#include <tuple>
 #include <utility>
 #include <variant>
 
@@ -76,6 +80,15 @@ static uint32_t sdrLastRemove = noTimestamp;
 static constexpr size_t lastRecordIndex = 0xFFFF;
 static constexpr int GENERAL_ERROR = -1;
 
+// OEM Get Multiple Sensor Readings request selector and response layout
+static constexpr uint8_t multiReadingLunMask = 0x03;
+static constexpr uint8_t multiReadingBitmap = 0x80;
+static constexpr size_t multiReadingBitmapSize = 32;
+static constexpr size_t multiReadingSize = 4;
+// IPMB framing and checksums, NetFn/Cmd/CC, the IANA and the count and
+// next sensor bytes, rounded up
+static constexpr size_t multiReadingRspOverhead = 16;
+
 static boost::container::flat_map<std::string, ObjectValueTree> SensorCache;
 
 // Specify the comparison required to sort and find char* map objects
@@ -117,12 +130,32 @@ static sdbusplus::bus::match::match sensorRemoved(
                             .count();
     });
 
-// this keeps track of deassertions for sensor event status command. A
-// deasertion can only happen if an assertion was seen first.
-static boost::container::flat_map<
-    std::string, boost::container::flat_map<std::string, std::optional<bool>>>
-    thresholdDeassertMap;
+namespace sensor
+{
+static constexpr const char* vrInterface =
+    "xyz.openbmc_project.Control.VoltageRegulatorMode";
+static constexpr const char* sensorInterface =
+    "xyz.openbmc_project.Sensor.Value";
+} // namespace sensor
+
+static_assert(sensor::maxSdrIdLength == FULL_RECORD_ID_STR_MAX_LENGTH);
+
+// Find the index entry of a sensor a signal was sent for. Signals for a
+// stale index are dropped, its replacement reads the state again anyway.
+static const SensorIndexEntry*
+    getSignalSensorEntry(sdbusplus::message::message& m,
+                         std::shared_ptr<SensorIndex>& sensorIndex)
+{
+    sensorIndex = details::getCurrentSensorIndex();
+    if (!sensorIndex)
+    {
+        return nullptr;
+    }
+    return sensorIndex->find(std::string_view(m.get_path()));
+}
 
+// Keep the threshold state in the sensor index current, so the threshold,
+// event status and reading commands do not need to read the sensor maps.
 static sdbusplus::bus::match::match thresholdChanged(
     *getSdBus(),
     "type='signal',member='PropertiesChanged',interface='org.freedesktop.DBus."
@@ -132,48 +165,79 @@ static sdbusplus::bus::match::match thresholdChanged(
             values;
         m.read(std::string(), values);
 
-        auto findAssert =
-            std::find_if(values.begin(), values.end(), [](const auto& pair) {
-                return pair.first.find("Alarm") != std::string::npos;
-            });
-        if (findAssert != values.end())
+        std::shared_ptr<SensorIndex> sensorIndex;
+        const SensorIndexEntry* entry = getSignalSensorEntry(m, sensorIndex);
+        if (entry == nullptr)
         {
-            auto ptr = std::get_if<bool>(&(findAssert->second));
-            if (ptr == nullptr)
-            {
-                phosphor::logging::log<phosphor::logging::level::ERR>(
-                    "thresholdChanged: Assert non bool");
-                return;
-            }
-            if (*ptr)
-            {
-                phosphor::logging::log<phosphor::logging::level::INFO>(
-                    "thresholdChanged: Assert",
-                    phosphor::logging::entry("SENSOR=%s", m.get_path()));
-                thresholdDeassertMap[m.get_path()][findAssert->first] = *ptr;
-            }
-            else
+            return;
+        }
+        SensorThresholdState& state = entry->thresholds;
+
+        for (const auto& [property, value] : values)
+        {
+            if (const bool* alarm = std::get_if<bool>(&value))
             {
-                auto& value =
-                    thresholdDeassertMap[m.get_path()][findAssert->first];
-                if (value)
+                std::optional<ThresholdLevel> level = getAlarmLevel(property);
+                if (!level)
+                {
+                    continue;
+                }
+                size_t index = static_cast<size_t>(*level);
+                if (*alarm)
+                {
+                    phosphor::logging::log<phosphor::logging::level::INFO>(
+                        "thresholdChanged: Assert",
+                        phosphor::logging::entry("SENSOR=%s", m.get_path()));
+                }
+                else if (state.asserted[index])
                 {
                     phosphor::logging::log<phosphor::logging::level::INFO>(
                         "thresholdChanged: deassert",
                         phosphor::logging::entry("SENSOR=%s", m.get_path()));
-                    value = *ptr;
                 }
+
+                // Until the state is read from the sensor map, only keep
+                // the assert history, the map will have the alarm itself
+                if (state.populated)
+                {
+                    state.updateAlarm(property, *alarm, true);
+                }
+                else if (*alarm)
+                {
+                    state.asserted[index] = true;
+                }
+            }
+            else if (state.populated)
+            {
+                state.updateThreshold(property, std::get<double>(value));
             }
         }
     });
 
-namespace sensor
-{
-static constexpr const char* vrInterface =
-    "xyz.openbmc_project.Control.VoltageRegulatorMode";
-static constexpr const char* sensorInterface =
-    "xyz.openbmc_project.Sensor.Value";
-} // namespace sensor
+static sdbusplus::bus::match::match vrModeChanged(
+    *getSdBus(),
+    "type='signal',member='PropertiesChanged',interface='org.freedesktop.DBus."
+    "Properties',arg0='xyz.openbmc_project.Control.VoltageRegulatorMode'",
+    [](sdbusplus::message::message& m) {
+        boost::container::flat_map<std::string, ipmi::Value> values;
+        m.read(std::string(), values);
+
+        std::shared_ptr<SensorIndex> sensorIndex;
+        const SensorIndexEntry* entry = getSignalSensorEntry(m, sensorIndex);
+        if (entry == nullptr || !entry->thresholds.populated)
+        {
+            return;
+        }
+
+        auto selected = values.find("Selected");
+        if (selected != values.end())
+        {
+            if (auto mode = std::get_if<std::string>(&selected->second))
+            {
+                entry->thresholds.vrSelected = *mode;
+            }
+        }
+    });
 
 static void getSensorMaxMin(const DbusInterfaceMap& sensorMap, double& max,
                             double& min)
@@ -236,7 +300,8 @@ static void getSensorMaxMin(const DbusInterfaceMap& sensorMap, double& max,
 
 static bool getSensorMap(ipmi::Context::ptr ctx, std::string sensorConnection,
                          std::string sensorPath, DbusInterfaceMap& sensorMap,
-                         int updatePeriod = sensorMapUpdatePeriod)
+                         int updatePeriod = sensorMapUpdatePeriod,
+                         std::chrono::milliseconds* cacheAge = nullptr)
 {
 #ifdef FEATURE_HYBRID_SENSORS
     if (auto sensor = findStaticSensor(sensorPath);
@@ -284,6 +349,11 @@ static bool getSensorMap(ipmi::Context::ptr ctx, std::string sensorConnection,
         // data to be cached for updatePeriod plus the build time.
         updateTimeMap[sensorConnection] = std::chrono::steady_clock::now();
     }
+    if (cacheAge != nullptr)
+    {
+        *cacheAge = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - updateTimeMap[sensorConnection]);
+    }
     auto connection = SensorCache.find(sensorConnection);
     if (connection == SensorCache.end())
     {
@@ -405,78 +475,19 @@ static std::optional<double>
     return value;
 }
 
-// Extract file name from sensor path as the sensors SDR ID. Simplify the name
-// if it is too long.
-std::string parseSdrIdFromPath(const std::string& path)
-{
-    std::string name;
-    size_t nameStart = path.rfind("/");
-    if (nameStart != std::string::npos)
-    {
-        name = path.substr(nameStart + 1, std::string::npos - nameStart);
-    }
-
-    std::replace(name.begin(), name.end(), '_', ' ');
-    if (name.size() > FULL_RECORD_ID_STR_MAX_LENGTH)
-    {
-        // try to not truncate by replacing common words
-        constexpr std::array<std::pair<const char*, const char*>, 2>
-            replaceWords = {std::make_pair("Output", "Out"),
-                            std::make_pair("Input", "In")};
-        for (const auto& [find, replace] : replaceWords)
-        {
-            boost::replace_all(name, find, replace);
-        }
-
-        name.resize(FULL_RECORD_ID_STR_MAX_LENGTH);
-    }
-    return name;
-}
-
-bool getVrEventStatus(ipmi::Context::ptr ctx, const std::string& connection,
-                      const std::string& path,
-                      const ipmi::DbusInterfaceMap::mapped_type& object,
+bool getVrEventStatus(const std::string& path,
+                      const SensorThresholdState& state,
                       std::bitset<16>& assertions)
 {
-    auto profiles = sensor::getSupportedVrProfiles(object);
-    if (!profiles)
-    {
-        return false;
-    }
-    ipmi::Value modeVariant;
-
-    auto ec = getDbusProperty(ctx, connection, path, sensor::vrInterface,
-                              "Selected", modeVariant);
-    if (ec)
-    {
-        log<level::ERR>("Failed to get property",
-                        entry("PROPERTY=%s", "Selected"),
-                        entry("PATH=%s", path.c_str()),
-                        entry("INTERFACE=%s", sensor::sensorInterface),
-                        entry("WHAT=%s", ec.message().c_str()));
-        return false;
-    }
-
-    auto mode = std::get_if<std::string>(&modeVariant);
-    if (mode == nullptr)
-    {
-        log<level::ERR>("property is not a string",
-                        entry("PROPERTY=%s", "Selected"),
-                        entry("PATH=%s", path.c_str()),
-                        entry("INTERFACE=%s", sensor::sensorInterface));
-        return false;
-    }
-
-    auto itr = std::find(profiles->begin(), profiles->end(), *mode);
-    if (itr == profiles->end())
+    std::optional<size_t> profileIndex = state.vrProfileIndex();
+    if (!profileIndex)
     {
         using namespace phosphor::logging;
         log<level::ERR>("VR mode doesn't match any of its profiles",
                         entry("PATH=%s", path.c_str()));
         return false;
     }
-    std::size_t index =
-        static_cast<std::size_t>(std::distance(profiles->begin(), itr));
+    std::size_t index = *profileIndex;
 
     // map index to reponse event assertion bit.
     if (index < 8)
@@ -497,12 +508,147 @@ bool getVrEventStatus(ipmi::Context::ptr ctx, const std::string& connection,
     if constexpr (debug)
     {
         std::cerr << "VR sensor " << sensor::parseSdrIdFromPath(path)
-                  << " mode is: [" << index << "] " << *mode << std::endl;
+                  << " mode is: [" << index << "] " << state.vrSelected
+                  << std::endl;
     }
     return true;
 }
 } // namespace sensor
 
+// Copy MaxValue/MinValue of Sensor.Value into the threshold state. No signal
+// keeps them current, so every caller with a fresh sensor map passes it here,
+// and the thresholds scale with the same range as the reading and the SDR.
+static void updateSensorRange(SensorThresholdState& state,
+                              const DbusInterfaceMap& sensorMap)
+{
+    auto sensorObject = sensorMap.find(sensor::sensorInterface);
+    if (sensorObject == sensorMap.end())
+    {
+        return;
+    }
+
+    auto maxMap = sensorObject->second.find("MaxValue");
+    auto minMap = sensorObject->second.find("MinValue");
+
+    if (maxMap != sensorObject->second.end())
+    {
+        state.maxValue = std::visit(VariantToDoubleVisitor(), maxMap->second);
+    }
+    if (minMap != sensorObject->second.end())
+    {
+        state.minValue = std::visit(VariantToDoubleVisitor(), minMap->second);
+    }
+}
+
+// Fill in the threshold state of a sensor from its sensor map. From then on
+// the thresholdChanged and vrModeChanged signals keep it up to date.
+static bool populateThresholdState(ipmi::Context::ptr ctx,
+                                   const SensorIndexEntry& sensorEntry,
+                                   const DbusInterfaceMap& sensorMap)
+{
+    SensorThresholdState& state = sensorEntry.thresholds;
+
+    auto vrObject = sensorMap.find(sensor::vrInterface);
+    if (vrObject != sensorMap.end())
+    {
+        auto profiles = sensor::getSupportedVrProfiles(vrObject->second);
+        if (!profiles)
+        {
+            return false;
+        }
+
+        ipmi::Value modeVariant;
+        auto ec = getDbusProperty(ctx, sensorEntry.service, sensorEntry.path,
+                                  sensor::vrInterface, "Selected", modeVariant);
+        if (ec)
+        {
+            log<level::ERR>("Failed to get property",
+                            entry("PROPERTY=%s", "Selected"),
+                            entry("PATH=%s", sensorEntry.path.c_str()),
+                            entry("INTERFACE=%s", sensor::vrInterface),
+                            entry("WHAT=%s", ec.message().c_str()));
+            return false;
+        }
+
+        auto mode = std::get_if<std::string>(&modeVariant);
+        if (mode == nullptr)
+        {
+            log<level::ERR>("property is not a string",
+                            entry("PROPERTY=%s", "Selected"),
+                            entry("PATH=%s", sensorEntry.path.c_str()),
+                            entry("INTERFACE=%s", sensor::vrInterface));
+            return false;
+        }
+
+        state.isVr = true;
+        state.vrProfiles = std::move(*profiles);
+        state.vrSelected = *mode;
+    }
+
+    updateSensorRange(state, sensorMap);
+
+    auto warningObject = sensorMap.find(warningThresholdInterface);
+    auto criticalObject = sensorMap.find(criticalThresholdInterface);
+    state.hasWarning = (warningObject != sensorMap.end());
+    state.hasCritical = (criticalObject != sensorMap.end());
+
+    for (auto object : {warningObject, criticalObject})
+    {
+        if (object == sensorMap.end())
+        {
+            continue;
+        }
+        for (const auto& [property, value] : object->second)
+        {
+            if (getAlarmLevel(property))
+            {
+                state.updateAlarm(property, std::get<bool>(value), false);
+            }
+            else if (getThresholdLevel(property))
+            {
+                state.updateThreshold(
+                    property, std::visit(VariantToDoubleVisitor(), value));
+            }
+        }
+    }
+
+    state.populated = true;
+    return true;
+}
+
+// Get the threshold state of a sensor, reading the sensor map only the
+// first time. sensorMap may pass in a map the caller already has, it also
+// refreshes the sensor range.
+static const SensorThresholdState*
+    getThresholdState(ipmi::Context::ptr ctx, const SensorIndexEntry& entry,
+                      const DbusInterfaceMap* sensorMap = nullptr)
+{
+    if (entry.thresholds.populated)
+    {
+        if (sensorMap != nullptr)
+        {
+            updateSensorRange(entry.thresholds, *sensorMap);
+        }
+        return &entry.thresholds;
+    }
+
+    DbusInterfaceMap readMap;
+    if (sensorMap == nullptr)
+    {
+        if (!getSensorMap(ctx, entry.service, entry.path, readMap))
+        {
+            return nullptr;
+        }
+        sensorMap = &readMap;
+    }
+
+    if (!populateThresholdState(ctx, entry, *sensorMap))
+    {
+        return nullptr;
+    }
+    return &entry.thresholds;
+}
+
 ipmi::RspType<> ipmiSenPlatformEvent(uint8_t generatorID, uint8_t evmRev,
                                      uint8_t sensorType, uint8_t sensorNum,
                                      uint8_t eventType, uint8_t eventData1,
@@ -628,31 +774,37 @@ ipmi::RspType<> ipmiSetSensorReading(ipmi::Context::ptr ctx,
     return ipmi::responseResponseError();
 }
 
-ipmi::RspType<uint8_t, uint8_t, uint8_t, std::optional<uint8_t>>
-    ipmiSenGetSensorReading(ipmi::Context::ptr ctx, uint8_t sensnum)
+// One sensor's Get Sensor Reading response bytes
+struct SensorReading
 {
-    std::string connection;
-    std::string path;
+    uint8_t value = 0;
+    uint8_t operation = 0;
+    uint8_t thresholds = 0;
+    std::optional<uint8_t> discrete;
+};
 
-    auto status = getSensorConnection(ctx, sensnum, connection, path);
-    if (status)
-    {
-        return ipmi::response(status);
-    }
+// Fill in the reading of an indexed sensor, shared by Get Sensor Reading
+// and the OEM Get Multiple Sensor Readings command.
+static ipmi::Cc getSensorReading(ipmi::Context::ptr ctx,
+                                 const SensorIndexEntry& entry,
+                                 SensorReading& sensorReading)
+{
+    const std::string& connection = entry.service;
+    const std::string& path = entry.path;
 
 #ifdef FEATURE_HYBRID_SENSORS
-    if (auto sensor = findStaticSensor(path);
+    if (auto sensor = findStaticSensor(entry);
         sensor != ipmi::sensor::sensors.end() &&
-        getSensorEventTypeFromPath(path) !=
+        entry.eventType !=
             static_cast<uint8_t>(SensorEventTypeCodes::threshold))
     {
         if (ipmi::sensor::Mutability::Read !=
             (sensor->second.mutability & ipmi::sensor::Mutability::Read))
         {
-            return ipmi::responseIllegalCommand();
+            return ipmi::ccIllegalCommand;
         }
 
-        uint8_t operation;
+        uint8_t& operation = sensorReading.operation;
         try
         {
             ipmi::sensor::GetSensorResponse getResponse =
@@ -673,31 +825,44 @@ ipmi::RspType<uint8_t, uint8_t, uint8_t, std::optional<uint8_t>>
                 operation |= static_cast<uint8_t>(
                     IPMISensorReadingByte2::eventMessagesEnable);
             }
-            return ipmi::responseSuccess(
-                getResponse.reading, operation,
-                getResponse.thresholdLevelsStates,
-                getResponse.discreteReadingSensorStates);
+            sensorReading.value = getResponse.reading;
+            sensorReading.thresholds = getResponse.thresholdLevelsStates;
+            sensorReading.discrete = getResponse.discreteReadingSensorStates;
+            return ipmi::ccSuccess;
         }
         catch (const std::exception& e)
         {
             operation |= static_cast<uint8_t>(
                 IPMISensorReadingByte2::readingStateUnavailable);
-            return ipmi::responseSuccess(0, operation, 0, std::nullopt);
+            return ipmi::ccSuccess;
         }
     }
 #endif
 
+    auto readStart = std::chrono::steady_clock::now();
+    std::chrono::milliseconds cacheAge{0};
     DbusInterfaceMap sensorMap;
-    if (!getSensorMap(ctx, connection, path, sensorMap))
+    bool mapFound = getSensorMap(ctx, connection, path, sensorMap,
+                                 sensorMapUpdatePeriod, &cacheAge);
+    if (details::sdrStatsTable.enabled())
     {
-        return ipmi::responseResponseError();
+        // Failed reads count too, a slow service is often a failing one
+        details::sdrStatsTable.updateTiming(
+            path,
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - readStart),
+            cacheAge);
+    }
+    if (!mapFound)
+    {
+        return ipmi::ccResponseError;
     }
     auto sensorObject = sensorMap.find(sensor::sensorInterface);
 
     if (sensorObject == sensorMap.end() ||
         sensorObject->second.find("Value") == sensorObject->second.end())
     {
-        return ipmi::responseResponseError();
+        return ipmi::ccResponseError;
     }
     auto& valueVariant = sensorObject->second["Value"];
     double reading = std::visit(VariantToDoubleVisitor(), valueVariant);
@@ -706,16 +871,12 @@ ipmi::RspType<uint8_t, uint8_t, uint8_t, std::optional<uint8_t>>
     double min = 0;
     getSensorMaxMin(sensorMap, max, min);
 
-    int16_t mValue = 0;
-    int16_t bValue = 0;
-    int8_t rExp = 0;
-    int8_t bExp = 0;
-    bool bSigned = false;
-
-    if (!getSensorAttributes(max, min, mValue, rExp, bValue, bExp, bSigned))
+    const SensorAttributes* attributes = entry.attributes.get(max, min);
+    if (attributes == nullptr)
     {
-        return ipmi::responseResponseError();
+        return ipmi::ccResponseError;
     }
+    const auto& [mValue, rExp, bValue, bExp, bSigned] = *attributes;
 
     uint8_t value =
         scaleIPMIValueFromDouble(reading, mValue, rExp, bValue, bExp, bSigned);
@@ -749,7 +910,7 @@ ipmi::RspType<uint8_t, uint8_t, uint8_t, std::optional<uint8_t>>
             IPMISensorReadingByte2::readingStateUnavailable);
     }
 
-    if constexpr (details::enableInstrumentation)
+    if (details::sdrStatsTable.enabled())
     {
         int byteValue;
         if (bSigned)
@@ -762,12 +923,12 @@ ipmi::RspType<uint8_t, uint8_t, uint8_t, std::optional<uint8_t>>
         }
 
         // Keep stats on the reading just obtained, even if it is "NaN"
-        if (details::sdrStatsTable.updateReading(sensnum, reading, byteValue))
+        if (details::sdrStatsTable.updateReading(path, reading, byteValue))
         {
             // This is the first reading, show the coefficients
             double step = (max - min) / 255.0;
             std::cerr << "IPMI sensor "
-                      << details::sdrStatsTable.getName(sensnum)
+                      << details::sdrStatsTable.getName(path)
                       << ": Range min=" << min << " max=" << max
                       << ", step=" << step
                       << ", Coefficients mValue=" << static_cast<int>(mValue)
@@ -780,56 +941,169 @@ ipmi::RspType<uint8_t, uint8_t, uint8_t, std::optional<uint8_t>>
 
     uint8_t thresholds = 0;
 
-    auto warningObject =
-        sensorMap.find("xyz.openbmc_project.Sensor.Threshold.Warning");
-    if (warningObject != sensorMap.end())
+    const SensorThresholdState* state =
+        getThresholdState(ctx, entry, &sensorMap);
+    if (state != nullptr)
     {
-        auto alarmHigh = warningObject->second.find("WarningAlarmHigh");
-        auto alarmLow = warningObject->second.find("WarningAlarmLow");
-        if (alarmHigh != warningObject->second.end())
+        if (state->alarm(ThresholdLevel::warningHigh))
         {
-            if (std::get<bool>(alarmHigh->second))
-            {
-                thresholds |= static_cast<uint8_t>(
-                    IPMISensorReadingByte3::upperNonCritical);
-            }
+            thresholds |=
+                static_cast<uint8_t>(IPMISensorReadingByte3::upperNonCritical);
         }
-        if (alarmLow != warningObject->second.end())
+        if (state->alarm(ThresholdLevel::warningLow))
         {
-            if (std::get<bool>(alarmLow->second))
-            {
-                thresholds |= static_cast<uint8_t>(
-                    IPMISensorReadingByte3::lowerNonCritical);
-            }
+            thresholds |=
+                static_cast<uint8_t>(IPMISensorReadingByte3::lowerNonCritical);
+        }
+        if (state->alarm(ThresholdLevel::criticalHigh))
+        {
+            thresholds |=
+                static_cast<uint8_t>(IPMISensorReadingByte3::upperCritical);
+        }
+        if (state->alarm(ThresholdLevel::criticalLow))
+        {
+            thresholds |=
+                static_cast<uint8_t>(IPMISensorReadingByte3::lowerCritical);
         }
     }
 
-    auto criticalObject =
-        sensorMap.find("xyz.openbmc_project.Sensor.Threshold.Critical");
-    if (criticalObject != sensorMap.end())
+    sensorReading.value = value;
+    sensorReading.operation = operation;
+    sensorReading.thresholds = thresholds;
+
+    // no discrete as of today so optional byte is never returned
+    return ipmi::ccSuccess;
+}
+
+ipmi::RspType<uint8_t, uint8_t, uint8_t, std::optional<uint8_t>>
+    ipmiSenGetSensorReading(ipmi::Context::ptr ctx, uint8_t sensnum)
+{
+    std::shared_ptr<SensorIndex> sensorIndex;
+    const SensorIndexEntry* entry = nullptr;
+
+    auto status = getSensorEntry(ctx, sensnum, sensorIndex, entry);
+    if (status)
+    {
+        return ipmi::response(status);
+    }
+
+    SensorReading sensorReading;
+    ipmi::Cc cc = getSensorReading(ctx, *entry, sensorReading);
+    if (cc != ipmi::ccSuccess)
+    {
+        return ipmi::response(cc);
+    }
+
+    return ipmi::responseSuccess(sensorReading.value, sensorReading.operation,
+                                 sensorReading.thresholds,
+                                 sensorReading.discrete);
+}
+
+/** @brief implements the OEM Get Multiple Sensor Readings command
+ *  @param selector - bits 1:0 LUN, bit 7 set when sensors holds a bitmap
+ *  @param sensors - start sensor number and count, or a bitmap of the
+ *                   sensor numbers to read, LSB of the first byte is 0
+ *
+ *  @returns IPMI completion code plus response data
+ *   - the number of readings returned
+ *   - the next sensor number to ask for, 0xFF when all were returned
+ *   - (sensor number, reading, Get Sensor Reading bytes 2 and 3) for each
+ */
+ipmi::RspType<uint8_t, uint8_t, std::vector<uint8_t>>
+    ipmiSenGetMultipleSensorReadings(ipmi::Context::ptr ctx, uint8_t selector,
+                                     std::vector<uint8_t> sensors)
+{
+    uint8_t lun = selector & multiReadingLunMask;
+    bool bitmap = (selector & multiReadingBitmap) != 0;
+    if ((selector & ~(multiReadingLunMask | multiReadingBitmap)) != 0 ||
+        lun == 2)
+    {
+        return ipmi::responseInvalidFieldRequest();
+    }
+
+    uint16_t first = 0;
+    uint16_t last = maxSensorsPerLUN;
+    if (bitmap)
     {
-        auto alarmHigh = criticalObject->second.find("CriticalAlarmHigh");
-        auto alarmLow = criticalObject->second.find("CriticalAlarmLow");
-        if (alarmHigh != criticalObject->second.end())
+        if (sensors.empty() || sensors.size() > multiReadingBitmapSize)
         {
-            if (std::get<bool>(alarmHigh->second))
-            {
-                thresholds |=
-                    static_cast<uint8_t>(IPMISensorReadingByte3::upperCritical);
-            }
+            return ipmi::responseReqDataLenInvalid();
         }
-        if (alarmLow != criticalObject->second.end())
+        last = std::min<uint16_t>(last, sensors.size() * 8);
+    }
+    else
+    {
+        if (sensors.size() != 2)
         {
-            if (std::get<bool>(alarmLow->second))
-            {
-                thresholds |=
-                    static_cast<uint8_t>(IPMISensorReadingByte3::lowerCritical);
-            }
+            return ipmi::responseReqDataLenInvalid();
+        }
+        first = sensors[0];
+        if (sensors[1] != 0)
+        {
+            last = std::min<uint16_t>(last, first + sensors[1]);
         }
     }
 
-    // no discrete as of today so optional byte is never returned
-    return ipmi::responseSuccess(value, operation, thresholds, std::nullopt);
+    std::shared_ptr<SensorIndex> sensorIndex;
+    details::getSensorIndex(sensorIndex);
+    if (!sensorIndex || sensorIndex->empty())
+    {
+        return ipmi::responseResponseError();
+    }
+
+    // Only return as many readings as the channel can carry back
+    size_t maxTransferSize = getChannelMaxTransferSize(ctx->channel);
+    if (maxTransferSize <= multiReadingRspOverhead)
+    {
+        return ipmi::responseResponseError();
+    }
+    size_t maxReadings = std::min<size_t>(
+        (maxTransferSize - multiReadingRspOverhead) / multiReadingSize,
+        std::numeric_limits<uint8_t>::max());
+
+    uint8_t count = 0;
+    uint8_t next = reservedSensorNumber;
+    std::vector<uint8_t> readings;
+    readings.reserve(maxReadings * multiReadingSize);
+
+    for (uint16_t sensnum = first; sensnum < last; sensnum++)
+    {
+        if (bitmap && !(sensors[sensnum / 8] & (1 << (sensnum % 8))))
+        {
+            continue;
+        }
+
+        const SensorIndexEntry* entry =
+            sensorIndex->find(static_cast<uint16_t>((lun << 8) | sensnum));
+        if (entry == nullptr)
+        {
+            continue;
+        }
+
+        if (count == maxReadings)
+        {
+            next = static_cast<uint8_t>(sensnum);
+            break;
+        }
+
+        // A sensor that can not be read is still returned, flagged as
+        // unavailable, so one bad sensor does not fail the whole batch
+        SensorReading sensorReading;
+        if (getSensorReading(ctx, *entry, sensorReading) != ipmi::ccSuccess)
+        {
+            sensorReading = SensorReading();
+            sensorReading.operation = static_cast<uint8_t>(
+                IPMISensorReadingByte2::readingStateUnavailable);
+        }
+
+        readings.push_back(static_cast<uint8_t>(sensnum));
+        readings.push_back(sensorReading.value);
+        readings.push_back(sensorReading.operation);
+        readings.push_back(sensorReading.thresholds);
+        count++;
+    }
+
+    return ipmi::responseSuccess(count, next, readings);
 }
 
 /** @brief implements the Set Sensor threshold command
@@ -878,14 +1152,17 @@ ipmi::RspType<> ipmiSenSetSensorThresholds(
         return ipmi::responseSuccess();
     }
 
-    std::string connection;
-    std::string path;
+    std::shared_ptr<SensorIndex> sensorIndex;
+    const SensorIndexEntry* entry = nullptr;
 
-    ipmi::Cc status = getSensorConnection(ctx, sensorNum, connection, path);
+    ipmi::Cc status = getSensorEntry(ctx, sensorNum, sensorIndex, entry);
     if (status)
     {
         return ipmi::response(status);
     }
+    const std::string& connection = entry->service;
+    const std::string& path = entry->path;
+
     DbusInterfaceMap sensorMap;
     if (!getSensorMap(ctx, connection, path, sensorMap))
     {
@@ -896,16 +1173,12 @@ ipmi::RspType<> ipmiSenSetSensorThresholds(
     double min = 0;
     getSensorMaxMin(sensorMap, max, min);
 
-    int16_t mValue = 0;
-    int16_t bValue = 0;
-    int8_t rExp = 0;
-    int8_t bExp = 0;
-    bool bSigned = false;
-
-    if (!getSensorAttributes(max, min, mValue, rExp, bValue, bExp, bSigned))
+    const SensorAttributes* attributes = entry->attributes.get(max, min);
+    if (attributes == nullptr)
     {
         return ipmi::responseResponseError();
     }
+    const auto& [mValue, rExp, bValue, bExp, bSigned] = *attributes;
 
     // store a vector of property name, value to set, and interface
     std::vector<std::tuple<std::string, uint8_t, std::string>> thresholdsToSet;
@@ -986,7 +1259,8 @@ ipmi::RspType<> ipmiSenSetSensorThresholds(
     return ipmi::responseSuccess();
 }
 
-IPMIThresholds getIPMIThresholds(const DbusInterfaceMap& sensorMap)
+IPMIThresholds getIPMIThresholds(const DbusInterfaceMap& sensorMap,
+                                 SensorAttributesCache& attributesCache)
 {
     IPMIThresholds resp;
     auto warningInterface =
@@ -1010,16 +1284,12 @@ IPMIThresholds getIPMIThresholds(const DbusInterfaceMap& sensorMap)
         double min = 0;
         getSensorMaxMin(sensorMap, max, min);
 
-        int16_t mValue = 0;
-        int16_t bValue = 0;
-        int8_t rExp = 0;
-        int8_t bExp = 0;
-        bool bSigned = false;
-
-        if (!getSensorAttributes(max, min, mValue, rExp, bValue, bExp, bSigned))
+        const SensorAttributes* attributes = attributesCache.get(max, min);
+        if (attributes == nullptr)
         {
             throw std::runtime_error("Invalid sensor atrributes");
         }
+        const auto& [mValue, rExp, bValue, bExp, bSigned] = *attributes;
         if (warningInterface != sensorMap.end())
         {
             auto& warningMap = warningInterface->second;
@@ -1069,6 +1339,49 @@ IPMIThresholds getIPMIThresholds(const DbusInterfaceMap& sensorMap)
     return resp;
 }
 
+IPMIThresholds getIPMIThresholds(const DbusInterfaceMap& sensorMap)
+{
+    SensorAttributesCache attributesCache;
+    return getIPMIThresholds(sensorMap, attributesCache);
+}
+
+IPMIThresholds getIPMIThresholds(const SensorThresholdState& state,
+                                 SensorAttributesCache& attributesCache)
+{
+    IPMIThresholds resp;
+    if (!state.hasWarning && !state.hasCritical)
+    {
+        return resp;
+    }
+
+    double max = 0;
+    double min = 0;
+    state.getMaxMin(max, min);
+
+    const SensorAttributes* attributes = attributesCache.get(max, min);
+    if (attributes == nullptr)
+    {
+        throw std::runtime_error("Invalid sensor atrributes");
+    }
+
+    auto scale = [&state, attributes](ThresholdLevel level,
+                                      std::optional<uint8_t>& scaled) {
+        const std::optional<double>& value = state.threshold(level);
+        if (value)
+        {
+            scaled = scaleIPMIValueFromDouble(
+                *value, attributes->mValue, attributes->rExp,
+                attributes->bValue, attributes->bExp, attributes->bSigned);
+        }
+    };
+    scale(ThresholdLevel::warningHigh, resp.warningHigh);
+    scale(ThresholdLevel::warningLow, resp.warningLow);
+    scale(ThresholdLevel::criticalHigh, resp.criticalHigh);
+    scale(ThresholdLevel::criticalLow, resp.criticalLow);
+
+    return resp;
+}
+
 ipmi::RspType<uint8_t, // readable
               uint8_t, // lowerNCrit
               uint8_t, // lowerCrit
@@ -1078,17 +1391,17 @@ ipmi::RspType<uint8_t, // readable
               uint8_t> // upperNRecoverable
     ipmiSenGetSensorThresholds(ipmi::Context::ptr ctx, uint8_t sensorNumber)
 {
-    std::string connection;
-    std::string path;
+    std::shared_ptr<SensorIndex> sensorIndex;
+    const SensorIndexEntry* entry = nullptr;
 
-    auto status = getSensorConnection(ctx, sensorNumber, connection, path);
+    auto status = getSensorEntry(ctx, sensorNumber, sensorIndex, entry);
     if (status)
     {
         return ipmi::response(status);
     }
 
-    DbusInterfaceMap sensorMap;
-    if (!getSensorMap(ctx, connection, path, sensorMap))
+    const SensorThresholdState* state = getThresholdState(ctx, *entry);
+    if (state == nullptr)
     {
         return ipmi::responseResponseError();
     }
@@ -1096,7 +1409,7 @@ ipmi::RspType<uint8_t, // readable
     IPMIThresholds thresholdData;
     try
     {
-        thresholdData = getIPMIThresholds(sensorMap);
+        thresholdData = getIPMIThresholds(*state, entry->attributes);
     }
     catch (std::exception&)
     {
@@ -1160,25 +1473,26 @@ ipmi::RspType<uint8_t, // enabled
               uint8_t> // deassertionEnabledMsb
     ipmiSenGetSensorEventEnable(ipmi::Context::ptr ctx, uint8_t sensorNum)
 {
-    std::string connection;
-    std::string path;
-
     uint8_t enabled = 0;
     uint8_t assertionEnabledLsb = 0;
     uint8_t assertionEnabledMsb = 0;
     uint8_t deassertionEnabledLsb = 0;
     uint8_t deassertionEnabledMsb = 0;
 
-    auto status = getSensorConnection(ctx, sensorNum, connection, path);
+    std::shared_ptr<SensorIndex> sensorIndex;
+    const SensorIndexEntry* entry = nullptr;
+    auto status = getSensorEntry(ctx, sensorNum, sensorIndex, entry);
     if (status)
     {
         return ipmi::response(status);
     }
+    const std::string& connection = entry->service;
+    const std::string& path = entry->path;
 
 #ifdef FEATURE_HYBRID_SENSORS
-    if (auto sensor = findStaticSensor(path);
+    if (auto sensor = findStaticSensor(*entry);
         sensor != ipmi::sensor::sensors.end() &&
-        getSensorEventTypeFromPath(path) !=
+        entry->eventType !=
             static_cast<uint8_t>(SensorEventTypeCodes::threshold))
     {
         enabled = static_cast<uint8_t>(
@@ -1284,9 +1598,9 @@ ipmi::RspType<uint8_t,         // sensorEventStatus
         return ipmi::responseInvalidFieldRequest();
     }
 
-    std::string connection;
-    std::string path;
-    auto status = getSensorConnection(ctx, sensorNum, connection, path);
+    std::shared_ptr<SensorIndex> sensorIndex;
+    const SensorIndexEntry* entry = nullptr;
+    auto status = getSensorEntry(ctx, sensorNum, sensorIndex, entry);
     if (status)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
@@ -1294,11 +1608,12 @@ ipmi::RspType<uint8_t,         // sensorEventStatus
             phosphor::logging::entry("SENSOR=%d", sensorNum));
         return ipmi::response(status);
     }
+    const std::string& path = entry->path;
 
 #ifdef FEATURE_HYBRID_SENSORS
-    if (auto sensor = findStaticSensor(path);
+    if (auto sensor = findStaticSensor(*entry);
         sensor != ipmi::sensor::sensors.end() &&
-        getSensorEventTypeFromPath(path) !=
+        entry->eventType !=
             static_cast<uint8_t>(SensorEventTypeCodes::threshold))
     {
         auto response = ipmi::sensor::get::mapDbusToAssertion(
@@ -1329,8 +1644,8 @@ ipmi::RspType<uint8_t,         // sensorEventStatus
     }
 #endif
 
-    DbusInterfaceMap sensorMap;
-    if (!getSensorMap(ctx, connection, path, sensorMap))
+    const SensorThresholdState* state = getThresholdState(ctx, *entry);
+    if (state == nullptr)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "ipmiSenGetSensorEventStatus: Sensor Mapping Error",
@@ -1344,11 +1659,9 @@ ipmi::RspType<uint8_t,         // sensorEventStatus
     std::bitset<16> deassertions = 0;
 
     // handle VR typed sensor
-    auto vrInterface = sensorMap.find(sensor::vrInterface);
-    if (vrInterface != sensorMap.end())
+    if (state->isVr)
     {
-        if (!sensor::getVrEventStatus(ctx, connection, path,
-                                      vrInterface->second, assertions))
+        if (!sensor::getVrEventStatus(path, *state, assertions))
         {
             return ipmi::responseResponseError();
         }
@@ -1359,103 +1672,49 @@ ipmi::RspType<uint8_t,         // sensorEventStatus
                                      deassertions);
     }
 
-    auto warningInterface =
-        sensorMap.find("xyz.openbmc_project.Sensor.Threshold.Warning");
-    auto criticalInterface =
-        sensorMap.find("xyz.openbmc_project.Sensor.Threshold.Critical");
-
-    std::optional<bool> criticalDeassertHigh =
-        thresholdDeassertMap[path]["CriticalAlarmHigh"];
-    std::optional<bool> criticalDeassertLow =
-        thresholdDeassertMap[path]["CriticalAlarmLow"];
-    std::optional<bool> warningDeassertHigh =
-        thresholdDeassertMap[path]["WarningAlarmHigh"];
-    std::optional<bool> warningDeassertLow =
-        thresholdDeassertMap[path]["WarningAlarmLow"];
-
-    if (criticalDeassertHigh && !*criticalDeassertHigh)
+    if (state->deasserted(ThresholdLevel::criticalHigh))
     {
         deassertions.set(static_cast<size_t>(
             IPMIGetSensorEventEnableThresholds::upperCriticalGoingHigh));
     }
-    if (criticalDeassertLow && !*criticalDeassertLow)
+    if (state->deasserted(ThresholdLevel::criticalLow))
     {
         deassertions.set(static_cast<size_t>(
             IPMIGetSensorEventEnableThresholds::upperCriticalGoingLow));
     }
-    if (warningDeassertHigh && !*warningDeassertHigh)
+    if (state->deasserted(ThresholdLevel::warningHigh))
     {
         deassertions.set(static_cast<size_t>(
             IPMIGetSensorEventEnableThresholds::upperNonCriticalGoingHigh));
     }
-    if (warningDeassertLow && !*warningDeassertLow)
+    if (state->deasserted(ThresholdLevel::warningLow))
     {
         deassertions.set(static_cast<size_t>(
             IPMIGetSensorEventEnableThresholds::lowerNonCriticalGoingHigh));
     }
-    if ((warningInterface != sensorMap.end()) ||
-        (criticalInterface != sensorMap.end()))
+    if (state->hasWarning || state->hasCritical)
     {
         sensorEventStatus = static_cast<size_t>(
             IPMISensorEventEnableByte2::eventMessagesEnable);
-        if (warningInterface != sensorMap.end())
+        if (state->alarm(ThresholdLevel::warningHigh))
         {
-            auto& warningMap = warningInterface->second;
-
-            auto warningHigh = warningMap.find("WarningAlarmHigh");
-            auto warningLow = warningMap.find("WarningAlarmLow");
-            auto warningHighAlarm = false;
-            auto warningLowAlarm = false;
-
-            if (warningHigh != warningMap.end())
-            {
-                warningHighAlarm = std::get<bool>(warningHigh->second);
-            }
-            if (warningLow != warningMap.end())
-            {
-                warningLowAlarm = std::get<bool>(warningLow->second);
-            }
-            if (warningHighAlarm)
-            {
-                assertions.set(
-                    static_cast<size_t>(IPMIGetSensorEventEnableThresholds::
-                                            upperNonCriticalGoingHigh));
-            }
-            if (warningLowAlarm)
-            {
-                assertions.set(
-                    static_cast<size_t>(IPMIGetSensorEventEnableThresholds::
-                                            lowerNonCriticalGoingLow));
-            }
+            assertions.set(static_cast<size_t>(
+                IPMIGetSensorEventEnableThresholds::upperNonCriticalGoingHigh));
         }
-        if (criticalInterface != sensorMap.end())
+        if (state->alarm(ThresholdLevel::warningLow))
         {
-            auto& criticalMap = criticalInterface->second;
-
-            auto criticalHigh = criticalMap.find("CriticalAlarmHigh");
-            auto criticalLow = criticalMap.find("CriticalAlarmLow");
-            auto criticalHighAlarm = false;
-            auto criticalLowAlarm = false;
-
-            if (criticalHigh != criticalMap.end())
-            {
-                criticalHighAlarm = std::get<bool>(criticalHigh->second);
-            }
-            if (criticalLow != criticalMap.end())
-            {
-                criticalLowAlarm = std::get<bool>(criticalLow->second);
-            }
-            if (criticalHighAlarm)
-            {
-                assertions.set(
-                    static_cast<size_t>(IPMIGetSensorEventEnableThresholds::
-                                            upperCriticalGoingHigh));
-            }
-            if (criticalLowAlarm)
-            {
-                assertions.set(static_cast<size_t>(
-                    IPMIGetSensorEventEnableThresholds::lowerCriticalGoingLow));
-            }
+            assertions.set(static_cast<size_t>(
+                IPMIGetSensorEventEnableThresholds::lowerNonCriticalGoingLow));
+        }
+        if (state->alarm(ThresholdLevel::criticalHigh))
+        {
+            assertions.set(static_cast<size_t>(
+                IPMIGetSensorEventEnableThresholds::upperCriticalGoingHigh));
+        }
+        if (state->alarm(ThresholdLevel::criticalLow))
+        {
+            assertions.set(static_cast<size_t>(
+                IPMIGetSensorEventEnableThresholds::lowerCriticalGoingLow));
         }
     }
 
@@ -1481,11 +1740,11 @@ void constructSensorSdrHeaderKey(uint16_t sensorNum, uint16_t recordID,
     record.key.sensor_number = sensornumber;
 }
 bool constructSensorSdr(ipmi::Context::ptr ctx, uint16_t sensorNum,
-                        uint16_t recordID, const std::string& service,
-                        const std::string& path,
+                        uint16_t recordID, const SensorIndexEntry& entry,
                         get_sdr::SensorDataFullRecord& record)
 {
-    uint8_t sensornumber = static_cast<uint8_t>(sensorNum);
+    const std::string& service = entry.service;
+    const std::string& path = entry.path;
     constructSensorSdrHeaderKey(sensorNum, recordID, record);
 
     DbusInterfaceMap sensorMap;
@@ -1498,18 +1757,22 @@ bool constructSensorSdr(ipmi::Context::ptr ctx, uint16_t sensorNum,
         return false;
     }
 
+    // Get Sensor Thresholds scales with the range of the SDR handed out
+    if (entry.thresholds.populated)
+    {
+        updateSensorRange(entry.thresholds, sensorMap);
+    }
+
     record.body.sensor_capabilities = 0x68; // auto rearm - todo hysteresis
-    record.body.sensor_type = getSensorTypeFromPath(path);
-    std::string type = getSensorTypeStringFromPath(path);
-    auto typeCstr = type.c_str();
-    auto findUnits = sensorUnits.find(typeCstr);
+    record.body.sensor_type = entry.sensorType;
+    auto findUnits = sensorUnits.find(entry.typeString.c_str());
     if (findUnits != sensorUnits.end())
     {
         record.body.sensor_units_2_base =
             static_cast<uint8_t>(findUnits->second);
     } // else default 0x0 unspecified
 
-    record.body.event_reading_type = getSensorEventTypeFromPath(path);
+    record.body.event_reading_type = entry.eventType;
 
     auto sensorObject = sensorMap.find(sensor::sensorInterface);
     if (sensorObject == sensorMap.end())
@@ -1610,13 +1873,13 @@ bool constructSensorSdr(ipmi::Context::ptr ctx, uint16_t sensorNum,
     // Original comment said "todo fill out rest of units"
 
     // populate sensor name from path
-    auto name = sensor::parseSdrIdFromPath(path);
+    const std::string& name = entry.sdrId;
     record.body.id_string_info = name.size();
     std::strncpy(record.body.id_string, name.c_str(),
                  sizeof(record.body.id_string));
 
     // Remember the sensor name, as determined for this sensor number
-    details::sdrStatsTable.updateName(sensornumber, name);
+    details::sdrStatsTable.updateName(path, sensorNum, name);
 
 #ifdef FEATURE_DYNAMIC_SENSORS_WRITE
     // Set the sensor settable state to true by default
@@ -1754,11 +2017,11 @@ void constructEventSdrHeaderKey(uint16_t sensorNum, uint16_t recordID,
 
 // Construct a type 3 SDR for VR typed sensor(daemon).
 bool constructVrSdr(ipmi::Context::ptr ctx, uint16_t sensorNum,
-                    uint16_t recordID, const std::string& service,
-                    const std::string& path,
+                    uint16_t recordID, const SensorIndexEntry& entry,
                     get_sdr::SensorDataEventRecord& record)
 {
-    uint8_t sensornumber = static_cast<uint8_t>(sensorNum);
+    const std::string& service = entry.service;
+    const std::string& path = entry.path;
     constructEventSdrHeaderKey(sensorNum, recordID, record);
 
     DbusInterfaceMap sensorMap;
@@ -1787,14 +2050,14 @@ bool constructVrSdr(ipmi::Context::ptr ctx, uint16_t sensorNum,
     record.body.sensor_record_sharing_2 = 0x00;
 
     // populate sensor name from path
-    auto name = sensor::parseSdrIdFromPath(path);
+    const std::string& name = entry.sdrId;
     int nameSize = std::min(name.size(), sizeof(record.body.id_string));
     record.body.id_string_info = nameSize;
     std::memset(record.body.id_string, 0x00, sizeof(record.body.id_string));
     std::memcpy(record.body.id_string, name.c_str(), nameSize);
 
     // Remember the sensor name, as determined for this sensor number
-    details::sdrStatsTable.updateName(sensornumber, name);
+    details::sdrStatsTable.updateName(path, sensorNum, name);
 
     return true;
 }
@@ -1861,25 +2124,20 @@ static int
         return 0;
     }
 
-    std::string connection;
-    std::string path;
-    std::vector<std::string> interfaces;
-
-    auto status =
-        getSensorConnection(ctx, recordID, connection, path, &interfaces);
-    if (status)
+    // Sensor records are numbered in sensor index order, and the index
+    // already knows the sensor number assigned to each of them.
+    std::shared_ptr<SensorIndex> sensorIndex;
+    details::getSensorIndex(sensorIndex);
+    const SensorIndexEntry* entry =
+        sensorIndex ? sensorIndex->record(recordID) : nullptr;
+    if (entry == nullptr)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
-            "getSensorDataRecord: getSensorConnection error");
-        return GENERAL_ERROR;
-    }
-    uint16_t sensorNum = getSensorNumberFromPath(path);
-    if (sensorNum == invalidSensorNumber)
-    {
-        phosphor::logging::log<phosphor::logging::level::ERR>(
-            "getSensorDataRecord: invalidSensorNumber");
+            "getSensorDataRecord: sensor index error");
         return GENERAL_ERROR;
     }
+    const std::vector<std::string>& interfaces = entry->interfaces;
+    uint16_t sensorNum = entry->sensorNumber;
 
     // Construct full record (SDR type 1) for the threshold sensors
     if (std::find(interfaces.begin(), interfaces.end(),
@@ -1893,8 +2151,7 @@ static int
         {
             constructSensorSdrHeaderKey(sensorNum, recordID, record);
         }
-        else if (!constructSensorSdr(ctx, sensorNum, recordID, connection, path,
-                                     record))
+        else if (!constructSensorSdr(ctx, sensorNum, recordID, *entry, record))
         {
             return GENERAL_ERROR;
         }
@@ -1906,9 +2163,9 @@ static int
     }
 
 #ifdef FEATURE_HYBRID_SENSORS
-    if (auto sensor = findStaticSensor(path);
+    if (auto sensor = findStaticSensor(*entry);
         sensor != ipmi::sensor::sensors.end() &&
-        getSensorEventTypeFromPath(path) !=
+        entry->eventType !=
             static_cast<uint8_t>(SensorEventTypeCodes::threshold))
     {
         get_sdr::SensorDataFullRecord record = {0};
@@ -1943,8 +2200,7 @@ static int
         {
             constructEventSdrHeaderKey(sensorNum, recordID, record);
         }
-        else if (!constructVrSdr(ctx, sensorNum, recordID, connection, path,
-                                 record))
+        else if (!constructVrSdr(ctx, sensorNum, recordID, *entry, record))
         {
             return GENERAL_ERROR;
         }
@@ -2218,8 +2474,63 @@ ipmi::RspType<uint16_t,            // next record ID
 }
 /* end storage commands */
 
+// Sensor read statistics, as one record per sensor:
+// (path, name, sensor number, good readings, missed readings, good streak,
+//  miss streak, min, max, read latency p50/p90/p99 in us,
+//  cache age p50/p90/p99 in ms)
+using SensorStatistics =
+    std::tuple<std::string, std::string, uint16_t, uint32_t, uint32_t,
+               uint32_t, uint32_t, double, double, uint64_t, uint64_t,
+               uint64_t, uint64_t, uint64_t, uint64_t>;
+
+static constexpr const char* sensorStatsPath =
+    "/xyz/openbmc_project/Ipmi/SensorStatistics";
+static constexpr const char* sensorStatsInterface =
+    "xyz.openbmc_project.Ipmi.SensorStatistics";
+
+static std::vector<SensorStatistics> getSensorStatistics()
+{
+    std::vector<SensorStatistics> statistics;
+    for (const auto& entry : details::sdrStatsTable.getEntries())
+    {
+        const details::StatsHistogram& latency = entry.getReadLatency();
+        const details::StatsHistogram& age = entry.getCacheAge();
+        statistics.emplace_back(
+            entry.getPath(), entry.getName(), entry.getSensorNumber(),
+            entry.getReadings(), entry.getMissings(), entry.getStreakRead(),
+            entry.getStreakMiss(), entry.getMin(), entry.getMax(),
+            latency.percentile(50), latency.percentile(90),
+            latency.percentile(99), age.percentile(50), age.percentile(90),
+            age.percentile(99));
+    }
+    return statistics;
+}
+
+// Put the statistics table on D-Bus, with an Enabled property to turn
+// the collection on and off at runtime
+static void registerSensorStatistics()
+{
+    static std::shared_ptr<sdbusplus::asio::dbus_interface> iface =
+        getObjectServer()->add_interface(sensorStatsPath,
+                                         sensorStatsInterface);
+
+    iface->register_property(
+        "Enabled", details::sdrStatsTable.enabled(),
+        [](const bool& req, bool& current) {
+            details::sdrStatsTable.setEnabled(req);
+            current = req;
+            return 1;
+        });
+    iface->register_method("GetStatistics", getSensorStatistics);
+    iface->register_method("Reset",
+                           []() { details::sdrStatsTable.clear(); });
+    iface->initialize();
+}
+
 void registerSensorFunctions()
 {
+    registerSensorStatistics();
+
     // <Platform Event>
     ipmi::registerHandler(ipmi::prioOpenBmcBase, ipmi::netFnSensor,
                           ipmi::sensor_event::cmdPlatformEvent,
@@ -2237,6 +2548,12 @@ void registerSensorFunctions()
                           ipmi::sensor_event::cmdGetSensorReading,
                           ipmi::Privilege::User, ipmiSenGetSensorReading);
 
+    // <Get Multiple Sensor Readings>
+    ipmi::registerOemHandler(ipmi::prioOpenBmcBase, oem::obmcOemNumber,
+                             oem::getMultipleSensorReadingsCmd,
+                             ipmi::Privilege::User,
+                             ipmiSenGetMultipleSensorReadings);
+
     // <Get Sensor Threshold>
     ipmi::registerHandler(ipmi::prioOpenBmcBase, ipmi::netFnSensor,
                           ipmi::sensor_event::cmdGetSensorThreshold,
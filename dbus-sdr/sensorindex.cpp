@@ -0,0 +1,98 @@
+/*
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "dbus-sdr/sensorindex.hpp"
+
+#include "dbus-sdr/sensortypes.hpp"
+
+#include <stdexcept>
+
+SensorIndex::SensorIndex()
+{
+    slots.fill(invalidSlot);
+}
+
+void SensorIndex::reserve(size_t count)
+{
+    if (count <= entries.capacity())
+    {
+        return;
+    }
+    entries.reserve(count);
+    pathIndex.reserve(count);
+    reindexPaths();
+}
+
+SensorIndexEntry&
+    SensorIndex::append(const std::string& path, const std::string& service,
+                        const std::vector<std::string>& interfaces)
+{
+    if (nextSensorNumber == invalidSensorNumber)
+    {
+        throw std::out_of_range("Maximum number of IPMI sensors exceeded.");
+    }
+
+    bool moved = (entries.size() == entries.capacity());
+    uint16_t slot = static_cast<uint16_t>(entries.size());
+
+    SensorIndexEntry& entry = entries.emplace_back();
+    entry.path = path;
+    entry.service = service;
+    entry.interfaces = interfaces;
+    entry.sensorNumber = nextSensorNumber;
+    entry.recordID = slot;
+    entry.typeString = getSensorTypeStringFromPath(path);
+    entry.sensorType = getSensorTypeFromPath(path);
+    entry.eventType = getSensorEventTypeFromPath(path);
+    entry.sdrId = ipmi::sensor::parseSdrIdFromPath(path);
+
+    slots[nextSensorNumber] = slot;
+    if (moved)
+    {
+        reindexPaths();
+    }
+    else
+    {
+        pathIndex.emplace(entry.path, slot);
+    }
+
+    // Assign numbers 0x000-0x0FE, 0x100-0x1FE, then 0x300-0x3FE, keeping
+    // 0xFF of each LUN reserved and leaving LUN 2 unused.
+    ++nextSensorNumber;
+    if (nextSensorNumber == maxSensorsPerLUN)
+    {
+        nextSensorNumber = lun1Sensor0;
+    }
+    else if (nextSensorNumber == (lun1Sensor0 | maxSensorsPerLUN))
+    {
+        nextSensorNumber = lun3Sensor0;
+    }
+    else if (nextSensorNumber == (lun3Sensor0 | maxSensorsPerLUN))
+    {
+        nextSensorNumber = invalidSensorNumber;
+    }
+
+    return entry;
+}
+
+void SensorIndex::reindexPaths()
+{
+    pathIndex.clear();
+    for (const auto& entry : entries)
+    {
+        pathIndex.emplace(entry.path, entry.recordID);
+    }
+}
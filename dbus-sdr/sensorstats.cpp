@@ -0,0 +1,195 @@
+/*
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "dbus-sdr/sensorstats.hpp"
+
+#include <cmath>
+#include <iostream>
+
+namespace details
+{
+
+void StatsHistogram::record(uint64_t value)
+{
+    size_t bucket = 0;
+    while ((bucket < (bucketCount - 1)) && (value >= (1ULL << bucket)))
+    {
+        ++bucket;
+    }
+    ++buckets[bucket];
+    ++total;
+}
+
+uint64_t StatsHistogram::percentile(unsigned int percent) const
+{
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    // Smallest count that covers the requested share of the samples
+    uint64_t wanted = (static_cast<uint64_t>(total) * percent + 99) / 100;
+    uint64_t seen = 0;
+    for (size_t bucket = 0; bucket < bucketCount; bucket++)
+    {
+        seen += buckets[bucket];
+        if ((seen >= wanted) && (seen != 0))
+        {
+            return 1ULL << bucket;
+        }
+    }
+    return 1ULL << (bucketCount - 1);
+}
+
+IPMIStatsEntry::IPMIStatsEntry(std::string_view path) : sensorPath(path)
+{
+    // Until the SDR names it, call the sensor by its last path element
+    auto slash = path.rfind('/');
+    sensorName =
+        (slash == std::string_view::npos) ? path : path.substr(slash + 1);
+}
+
+bool IPMIStatsEntry::updateReading(double reading, int raw)
+{
+    bool first = ((numReadings == 0) && (numMissings == 0));
+
+    // Sensors can use "nan" to indicate unavailable reading
+    if (!(std::isfinite(reading)))
+    {
+        // Only show this if beginning a new streak
+        if (numStreakMiss == 0)
+        {
+            std::cerr << "IPMI sensor " << sensorName
+                      << ": Missing reading, byte=" << raw
+                      << ", Reading counts good=" << numReadings
+                      << " miss=" << numMissings
+                      << ", Prior good streak=" << numStreakRead << "\n";
+        }
+
+        numStreakRead = 0;
+        ++numMissings;
+        ++numStreakMiss;
+
+        return first;
+    }
+
+    // Only show this if beginning a new streak and not the first time
+    if ((numStreakRead == 0) && (numReadings != 0))
+    {
+        std::cerr << "IPMI sensor " << sensorName
+                  << ": Recovered reading, value=" << reading
+                  << " byte=" << raw << ", Reading counts good=" << numReadings
+                  << " miss=" << numMissings
+                  << ", Prior miss streak=" << numStreakMiss << "\n";
+    }
+
+    // Initialize min/max if the first successful reading
+    if (numReadings == 0)
+    {
+        std::cerr << "IPMI sensor " << sensorName
+                  << ": First reading, value=" << reading << " byte=" << raw
+                  << "\n";
+
+        minValue = reading;
+        maxValue = reading;
+    }
+
+    numStreakMiss = 0;
+    ++numReadings;
+    ++numStreakRead;
+
+    // Only provide subsequent output if new min/max established
+    if (reading < minValue)
+    {
+        std::cerr << "IPMI sensor " << sensorName
+                  << ": Lowest reading, value=" << reading << " byte=" << raw
+                  << "\n";
+
+        minValue = reading;
+    }
+
+    if (reading > maxValue)
+    {
+        std::cerr << "IPMI sensor " << sensorName
+                  << ": Highest reading, value=" << reading << " byte=" << raw
+                  << "\n";
+
+        maxValue = reading;
+    }
+
+    return first;
+}
+
+void IPMIStatsEntry::updateTiming(std::chrono::microseconds readTime,
+                                  std::chrono::milliseconds age)
+{
+    readLatency.record(static_cast<uint64_t>(readTime.count()));
+    cacheAge.record(static_cast<uint64_t>(age.count()));
+}
+
+IPMIStatsEntry& IPMIStatsTable::findEntry(std::string_view path)
+{
+    auto findPath = pathIndex.find(path);
+    if (findPath != pathIndex.end())
+    {
+        return entries[findPath->second];
+    }
+
+    pathIndex.emplace(std::string(path), entries.size());
+    return entries.emplace_back(path);
+}
+
+void IPMIStatsTable::wipeTable(void)
+{
+    for (auto& entry : entries)
+    {
+        entry.updateSensorNumber(invalidSensorNumber);
+    }
+}
+
+void IPMIStatsTable::clear(void)
+{
+    pathIndex.clear();
+    entries.clear();
+}
+
+const std::string& IPMIStatsTable::getName(std::string_view path)
+{
+    return findEntry(path).getName();
+}
+
+void IPMIStatsTable::updateName(std::string_view path, uint16_t sensorNumber,
+                                std::string_view name)
+{
+    IPMIStatsEntry& entry = findEntry(path);
+    entry.updateSensorNumber(sensorNumber);
+    entry.updateName(name);
+}
+
+bool IPMIStatsTable::updateReading(std::string_view path, double reading,
+                                   int raw)
+{
+    return findEntry(path).updateReading(reading, raw);
+}
+
+void IPMIStatsTable::updateTiming(std::string_view path,
+                                  std::chrono::microseconds readTime,
+                                  std::chrono::milliseconds age)
+{
+    findEntry(path).updateTiming(readTime, age);
+}
+
+} // namespace details
@@ -0,0 +1,116 @@
+/*
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#include "dbus-sdr/sensorthresholds.hpp"
+
+#include <algorithm>
+
+namespace ipmi
+{
+
+// Property names, in ThresholdLevel order
+static constexpr std::array<std::string_view, thresholdLevels>
+    thresholdProperties = {"WarningHigh", "WarningLow", "CriticalHigh",
+                           "CriticalLow"};
+static constexpr std::array<std::string_view, thresholdLevels>
+    alarmProperties = {"WarningAlarmHigh", "WarningAlarmLow",
+                       "CriticalAlarmHigh", "CriticalAlarmLow"};
+
+static std::optional<ThresholdLevel>
+    findProperty(const std::array<std::string_view, thresholdLevels>& names,
+                 std::string_view property)
+{
+    auto found = std::find(names.begin(), names.end(), property);
+    if (found == names.end())
+    {
+        return std::nullopt;
+    }
+    return static_cast<ThresholdLevel>(std::distance(names.begin(), found));
+}
+
+std::optional<ThresholdLevel> getThresholdLevel(std::string_view property)
+{
+    return findProperty(thresholdProperties, property);
+}
+
+std::optional<ThresholdLevel> getAlarmLevel(std::string_view property)
+{
+    return findProperty(alarmProperties, property);
+}
+
+bool SensorThresholdState::updateThreshold(std::string_view property,
+                                           double value)
+{
+    std::optional<ThresholdLevel> level = getThresholdLevel(property);
+    if (!level)
+    {
+        return false;
+    }
+    thresholds[static_cast<size_t>(*level)] = value;
+    return true;
+}
+
+bool SensorThresholdState::updateAlarm(std::string_view property, bool value,
+                                       bool event)
+{
+    std::optional<ThresholdLevel> level = getAlarmLevel(property);
+    if (!level)
+    {
+        return false;
+    }
+    size_t index = static_cast<size_t>(*level);
+    alarms[index] = value;
+    if (event && value)
+    {
+        asserted[index] = true;
+    }
+    return true;
+}
+
+void SensorThresholdState::getMaxMin(double& max, double& min) const
+{
+    max = maxValue;
+    min = minValue;
+
+    for (ThresholdLevel level :
+         {ThresholdLevel::criticalHigh, ThresholdLevel::warningHigh})
+    {
+        if (threshold(level))
+        {
+            max = std::max(*threshold(level), max);
+        }
+    }
+    for (ThresholdLevel level :
+         {ThresholdLevel::criticalLow, ThresholdLevel::warningLow})
+    {
+        if (threshold(level))
+        {
+            min = std::min(*threshold(level), min);
+        }
+    }
+}
+
+std::optional<size_t> SensorThresholdState::vrProfileIndex() const
+{
+    auto itr = std::find(vrProfiles.begin(), vrProfiles.end(), vrSelected);
+    if (itr == vrProfiles.end())
+    {
+        return std::nullopt;
+    }
+    return static_cast<size_t>(std::distance(vrProfiles.begin(), itr));
+}
+
+} // namespace ipmi
@@ -303,6 +303,28 @@ uint8_t scaleIPMIValueFromDouble(const double value, const int16_t mValue,
     return static_cast<uint8_t>(clampedValue);
 }
 
+const SensorAttributes* SensorAttributesCache::get(const double max,
+                                                   const double min)
+{
+    // NaN never compares equal, so an unusable range is solved every time
+    // and keeps being reported as invalid.
+    if (solved && (max == cachedMax) && (min == cachedMin))
+    {
+        return valid ? &attributes : nullptr;
+    }
+
+    SensorAttributes newAttributes;
+    valid = getSensorAttributes(max, min, newAttributes.mValue,
+                                newAttributes.rExp, newAttributes.bValue,
+                                newAttributes.bExp, newAttributes.bSigned);
+    attributes = newAttributes;
+    cachedMax = max;
+    cachedMin = min;
+    solved = true;
+
+    return valid ? &attributes : nullptr;
+}
+
 uint8_t getScaledIPMIValue(const double value, const double max,
                            const double min)
 {
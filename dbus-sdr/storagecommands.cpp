@@ -16,10 +16,17 @@
 
 #include "dbus-sdr/storagecommands.hpp"
 
+#include "dbus-sdr/frucache.hpp"
 #include "dbus-sdr/sdrutils.hpp"
+#include "dbus-sdr/selindex.hpp"
+#include "dbus-sdr/seljournal.hpp"
+#include "host-event-buffer.hpp"
 #include "selutility.hpp"
 
+#include <unistd.h>
+
 #include <boost/algorithm/string.hpp>
+#include <boost/asio/posix/stream_descriptor.hpp>
 #include <boost/container/flat_map.hpp>
 #include <boost/process.hpp>
 #include <filesystem>
@@ -40,6 +47,7 @@ namespace dynamic_sensors::ipmi::sel
 {
 static const std::filesystem::path selLogDir = "/var/log";
 static const std::string selLogFilename = "ipmi_sel";
+static constexpr const char* selJournalFile = "/var/lib/ipmi/sel_journal";
 
 static int getFileTimestamp(const std::filesystem::path& file)
 {
@@ -107,13 +115,12 @@ constexpr static const char* chassisTypeRackMount = "23";
 // event direction is bit[7] of eventType where 1b = Deassertion event
 constexpr static const uint8_t deassertionEvent = 0x80;
 
-static std::vector<uint8_t> fruCache;
-static uint8_t cacheBus = 0xFF;
-static uint8_t cacheAddr = 0XFF;
-static uint8_t lastDevId = 0xFF;
+using dynamic_sensors::ipmi::fru::FruCache;
+using dynamic_sensors::ipmi::fru::FruImage;
 
-static uint8_t writeBus = 0xFF;
-static uint8_t writeAddr = 0XFF;
+static FruCache fruCache;
+// Device whose image was changed by Write FRU Data, for writeFru
+static uint8_t writeDevId = 0xFF;
 
 std::unique_ptr<phosphor::Timer> writeTimer = nullptr;
 static std::vector<sdbusplus::bus::match::match> fruMatches;
@@ -128,15 +135,21 @@ void registerStorageFunctions() __attribute__((constructor));
 
 bool writeFru()
 {
-    if (writeBus == 0xFF && writeAddr == 0xFF)
+    if (writeDevId == 0xFF)
     {
         return true;
     }
+    FruImage* image = fruCache.peek(writeDevId);
+    if (image == nullptr || !image->dirty)
+    {
+        writeDevId = 0xFF;
+        return true;
+    }
     std::shared_ptr<sdbusplus::asio::connection> dbus = getSdBus();
     sdbusplus::message::message writeFru = dbus->new_method_call(
         fruDeviceServiceName, "/xyz/openbmc_project/FruDevice",
         "xyz.openbmc_project.FruDeviceManager", "WriteFru");
-    writeFru.append(writeBus, writeAddr, fruCache);
+    writeFru.append(image->bus, image->addr, *image->data);
     try
     {
         sdbusplus::message::message writeFruResp = dbus->call(writeFru);
@@ -148,8 +161,8 @@ bool writeFru()
             "error writing fru");
         return false;
     }
-    writeBus = 0xFF;
-    writeAddr = 0xFF;
+    image->dirty = false;
+    writeDevId = 0xFF;
     return true;
 }
 
@@ -244,50 +257,118 @@ void replaceCacheFru(const std::shared_ptr<sdbusplus::asio::connection>& bus,
     recalculateHashes();
 }
 
-ipmi::Cc getFru(ipmi::Context::ptr ctx, uint8_t devId)
+// Drop the cached images of devices that are gone or have moved
+void pruneFruCache()
 {
-    if (lastDevId == devId && devId != 0xFF)
+    for (uint16_t devId = 0; devId < 0xFF; devId++)
     {
-        return ipmi::ccSuccess;
+        FruImage* image = fruCache.peek(devId);
+        if (image == nullptr)
+        {
+            continue;
+        }
+        auto deviceFind = deviceHashes.find(devId);
+        if (deviceFind == deviceHashes.end() ||
+            deviceFind->second != std::make_pair(image->bus, image->addr))
+        {
+            fruCache.erase(devId);
+        }
     }
+}
 
+ipmi::Cc getFru(ipmi::Context::ptr ctx, uint8_t devId, FruImage*& image)
+{
     // Set devId to 1 if devId is 0.
     // 0 is reserved for baseboard and set to 1 in recalculateHashes().
     if (!devId)
         devId = 1;
 
+    image = fruCache.find(devId);
+    if (image != nullptr)
+    {
+        return ipmi::ccSuccess;
+    }
+
     auto deviceFind = deviceHashes.find(devId);
     if (deviceFind == deviceHashes.end())
     {
         return IPMI_CC_SENSOR_INVALID;
     }
-
-    fruCache.clear();
-
-    cacheBus = deviceFind->second.first;
-    cacheAddr = deviceFind->second.second;
+    std::pair<uint8_t, uint8_t> device = deviceFind->second;
 
     boost::system::error_code ec;
 
-    fruCache = ctx->bus->yield_method_call<std::vector<uint8_t>>(
-        ctx->yield, ec, fruDeviceServiceName, "/xyz/openbmc_project/FruDevice",
-        "xyz.openbmc_project.FruDeviceManager", "GetRawFru", cacheBus,
-        cacheAddr);
+    std::vector<uint8_t> data =
+        ctx->bus->yield_method_call<std::vector<uint8_t>>(
+            ctx->yield, ec, fruDeviceServiceName,
+            "/xyz/openbmc_project/FruDevice",
+            "xyz.openbmc_project.FruDeviceManager", "GetRawFru", device.first,
+            device.second);
     if (ec)
     {
         phosphor::logging::log<phosphor::logging::level::ERR>(
             "Couldn't get raw fru",
             phosphor::logging::entry("ERROR=%s", ec.message().c_str()));
 
-        cacheBus = 0xFF;
-        cacheAddr = 0xFF;
         return ipmi::ccResponseError;
     }
 
-    lastDevId = devId;
+    // Another request may have read, and written to, the image meanwhile
+    image = fruCache.find(devId);
+    if (image != nullptr)
+    {
+        return ipmi::ccSuccess;
+    }
+    deviceFind = deviceHashes.find(devId);
+    if (deviceFind == deviceHashes.end() || deviceFind->second != device)
+    {
+        return ipmi::ccResponseError;
+    }
+    image = &fruCache.insert(devId, device.first, device.second,
+                             std::move(data));
     return ipmi::ccSuccess;
 }
 
+#ifdef FEATURE_FRU_PREFETCH
+// Read the FRUs into the cache ahead of the first FRU command
+void prefetchFrus(const std::shared_ptr<sdbusplus::asio::connection>& bus,
+                  boost::asio::yield_context& yield)
+{
+    // The devices may change while waiting for the reads
+    std::vector<std::pair<uint8_t, std::pair<uint8_t, uint8_t>>> devices(
+        deviceHashes.begin(), deviceHashes.end());
+    if (devices.size() > fruCache.capacity())
+    {
+        devices.resize(fruCache.capacity());
+    }
+    for (const auto& [devId, device] : devices)
+    {
+        if (fruCache.peek(devId) != nullptr)
+        {
+            continue;
+        }
+        boost::system::error_code ec;
+        std::vector<uint8_t> data =
+            bus->yield_method_call<std::vector<uint8_t>>(
+                yield, ec, fruDeviceServiceName,
+                "/xyz/openbmc_project/FruDevice",
+                "xyz.openbmc_project.FruDeviceManager", "GetRawFru",
+                device.first, device.second);
+        if (ec)
+        {
+            continue;
+        }
+        auto deviceFind = deviceHashes.find(devId);
+        if (fruCache.peek(devId) == nullptr &&
+            deviceFind != deviceHashes.end() && deviceFind->second == device)
+        {
+            fruCache.insert(devId, device.first, device.second,
+                            std::move(data));
+        }
+    }
+}
+#endif
+
 void writeFruIfRunning()
 {
     if (!writeTimer->isRunning())
@@ -331,7 +412,18 @@ void startMatch(void)
                                 writeFruIfRunning();
                                 frus[path] = object;
                                 recalculateHashes();
-                                lastDevId = 0xFF;
+                                pruneFruCache();
+                                // The device may have been rescanned
+                                auto busFind = findType->second.find("BUS");
+                                auto addrFind =
+                                    findType->second.find("ADDRESS");
+                                if (busFind != findType->second.end() &&
+                                    addrFind != findType->second.end())
+                                {
+                                    fruCache.eraseDevice(
+                                        std::get<uint32_t>(busFind->second),
+                                        std::get<uint32_t>(addrFind->second));
+                                }
                             });
 
     fruMatches.emplace_back(*bus,
@@ -357,12 +449,15 @@ void startMatch(void)
                                 writeFruIfRunning();
                                 frus.erase(path);
                                 recalculateHashes();
-                                lastDevId = 0xFF;
+                                pruneFruCache();
                             });
 
     // call once to populate
     boost::asio::spawn(*getIoContext(), [](boost::asio::yield_context yield) {
         replaceCacheFru(getSdBus(), yield);
+#ifdef FEATURE_FRU_PREFETCH
+        prefetchFrus(getSdBus(), yield);
+#endif
     });
 }
 
@@ -374,8 +469,8 @@ void startMatch(void)
  *  @returns ipmi completion code plus response data
  *   - countWritten  - Count written
  */
-ipmi::RspType<uint8_t,             // Count
-              std::vector<uint8_t> // Requested data
+ipmi::RspType<uint8_t,          // Count
+              ipmi::SharedBytes // Requested data
               >
     ipmiStorageReadFruData(ipmi::Context::ptr ctx, uint8_t fruDeviceId,
                            uint16_t fruInventoryOffset, uint8_t countToRead)
@@ -385,35 +480,33 @@ ipmi::RspType<uint8_t,             // Count
         return ipmi::responseInvalidFieldRequest();
     }
 
-    ipmi::Cc status = getFru(ctx, fruDeviceId);
+    FruImage* image = nullptr;
+    ipmi::Cc status = getFru(ctx, fruDeviceId, image);
 
     if (status != ipmi::ccSuccess)
     {
         return ipmi::response(status);
     }
+    const std::vector<uint8_t>& fruData = *image->data;
 
     size_t fromFruByteLen = 0;
-    if (countToRead + fruInventoryOffset < fruCache.size())
+    if (countToRead + fruInventoryOffset < fruData.size())
     {
         fromFruByteLen = countToRead;
     }
-    else if (fruCache.size() > fruInventoryOffset)
+    else if (fruData.size() > fruInventoryOffset)
     {
-        fromFruByteLen = fruCache.size() - fruInventoryOffset;
+        fromFruByteLen = fruData.size() - fruInventoryOffset;
     }
     else
     {
         return ipmi::responseReqDataLenExceeded();
     }
 
-    std::vector<uint8_t> requestedData;
-
-    requestedData.insert(
-        requestedData.begin(), fruCache.begin() + fruInventoryOffset,
-        fruCache.begin() + fruInventoryOffset + fromFruByteLen);
-
-    return ipmi::responseSuccess(static_cast<uint8_t>(requestedData.size()),
-                                 requestedData);
+    // Packed straight from the cached image
+    return ipmi::responseSuccess(
+        static_cast<uint8_t>(fromFruByteLen),
+        ipmi::SharedBytes(image->data, fruInventoryOffset, fromFruByteLen));
 }
 
 /** @brief implements the write FRU data command
@@ -436,25 +529,42 @@ ipmi::RspType<uint8_t>
 
     size_t writeLen = dataToWrite.size();
 
-    ipmi::Cc status = getFru(ctx, fruDeviceId);
+    FruImage* image = nullptr;
+    ipmi::Cc status = getFru(ctx, fruDeviceId, image);
     if (status != ipmi::ccSuccess)
     {
         return ipmi::response(status);
     }
+    // Changes are written back for one device at a time, finish another
+    // device's before this one is changed
+    if (writeDevId != 0xFF && writeDevId != image->devId)
+    {
+        writeTimer->stop();
+        if (!writeFru())
+        {
+            // Given up, as when the device is switched without a cache
+            fruCache.erase(writeDevId);
+            writeDevId = 0xFF;
+        }
+    }
+    std::vector<uint8_t>& fruData = image->writable();
+    image->dirty = true;
+    writeDevId = image->devId;
+
     size_t lastWriteAddr = fruInventoryOffset + writeLen;
-    if (fruCache.size() < lastWriteAddr)
+    if (fruData.size() < lastWriteAddr)
     {
-        fruCache.resize(fruInventoryOffset + writeLen);
+        fruData.resize(fruInventoryOffset + writeLen);
     }
 
     std::copy(dataToWrite.begin(), dataToWrite.begin() + writeLen,
-              fruCache.begin() + fruInventoryOffset);
+              fruData.begin() + fruInventoryOffset);
 
     bool atEnd = false;
 
-    if (fruCache.size() >= sizeof(FRUHeader))
+    if (fruData.size() >= sizeof(FRUHeader))
     {
-        FRUHeader* header = reinterpret_cast<FRUHeader*>(fruCache.data());
+        FRUHeader* header = reinterpret_cast<FRUHeader*>(fruData.data());
 
         size_t areaLength = 0;
         size_t lastRecordStart = std::max(
@@ -471,9 +581,9 @@ ipmi::RspType<uint8_t>
             {
                 // The MSB in the second byte of the MultiRecord header signals
                 // "End of list"
-                endOfList = fruCache[lastRecordStart + 1] & 0x80;
+                endOfList = fruData[lastRecordStart + 1] & 0x80;
                 // Third byte in the MultiRecord header is the length
-                areaLength = fruCache[lastRecordStart + 2];
+                areaLength = fruData[lastRecordStart + 2];
                 // This length is in bytes (not 8 bytes like other headers)
                 areaLength += 5; // The length omits the 5 byte header
                 if (!endOfList)
@@ -490,7 +600,7 @@ ipmi::RspType<uint8_t>
             if (lastWriteAddr > (lastRecordStart + 1))
             {
                 // second byte in record area is the length
-                areaLength = fruCache[lastRecordStart + 1];
+                areaLength = fruData[lastRecordStart + 1];
                 areaLength *= 8; // it is in multiples of 8 bytes
             }
         }
@@ -501,8 +611,6 @@ ipmi::RspType<uint8_t>
     }
     uint8_t countWritten = 0;
 
-    writeBus = cacheBus;
-    writeAddr = cacheAddr;
     if (atEnd)
     {
         // cancel timer, we're at the end so might as well send it
@@ -511,7 +619,7 @@ ipmi::RspType<uint8_t>
         {
             return ipmi::responseInvalidFieldRequest();
         }
-        countWritten = std::min(fruCache.size(), static_cast<size_t>(0xFF));
+        countWritten = std::min(fruData.size(), static_cast<size_t>(0xFF));
     }
     else
     {
@@ -541,7 +649,8 @@ ipmi::RspType<uint16_t, // inventorySize
         return ipmi::responseInvalidFieldRequest();
     }
 
-    ipmi::Cc ret = getFru(ctx, fruDeviceId);
+    FruImage* image = nullptr;
+    ipmi::Cc ret = getFru(ctx, fruDeviceId, image);
     if (ret != ipmi::ccSuccess)
     {
         return ipmi::response(ret);
@@ -550,7 +659,7 @@ ipmi::RspType<uint16_t, // inventorySize
     constexpr uint8_t accessType =
         static_cast<uint8_t>(GetFRUAreaAccessType::byte);
 
-    return ipmi::responseSuccess(fruCache.size(), accessType);
+    return ipmi::responseSuccess(image->data->size(), accessType);
 }
 
 ipmi_ret_t getFruSdrCount(ipmi::Context::ptr ctx, size_t& count)
@@ -738,123 +847,330 @@ ipmi_ret_t getFruSdrs(ipmi::Context::ptr ctx, size_t index,
     return IPMI_CC_OK;
 }
 
-static bool getSELLogFiles(std::vector<std::filesystem::path>& selLogFiles)
+// The record ID index of the ipmi_sel files, as last refreshed
+static dynamic_sensors::ipmi::sel::SELIndex& selTextIndex()
+{
+    static dynamic_sensors::ipmi::sel::SELIndex selIndex(
+        dynamic_sensors::ipmi::sel::selLogDir,
+        dynamic_sensors::ipmi::sel::selLogFilename);
+    return selIndex;
+}
+
+// The record ID index of the ipmi_sel files, caught up with any changes
+static dynamic_sensors::ipmi::sel::SELIndex& getSELIndex()
 {
-    // Loop through the directory looking for ipmi_sel log files
-    for (const std::filesystem::directory_entry& dirEnt :
-         std::filesystem::directory_iterator(
-             dynamic_sensors::ipmi::sel::selLogDir))
-    {
-        std::string filename = dirEnt.path().filename();
-        if (boost::starts_with(filename,
-                               dynamic_sensors::ipmi::sel::selLogFilename))
+    dynamic_sensors::ipmi::sel::SELIndex& selIndex = selTextIndex();
+    selIndex.refresh();
+    return selIndex;
+}
+
+static int fromHexStr(const std::string& hexStr, std::vector<uint8_t>& data)
+{
+    for (unsigned int i = 0; i < hexStr.size(); i += 2)
+    {
+        try
+        {
+            data.push_back(static_cast<uint8_t>(
+                std::stoul(hexStr.substr(i, 2), nullptr, 16)));
+        }
+        catch (std::invalid_argument& e)
         {
-            // If we find an ipmi_sel log file, save the path
-            selLogFiles.emplace_back(dynamic_sensors::ipmi::sel::selLogDir /
-                                     filename);
+            phosphor::logging::log<phosphor::logging::level::ERR>(e.what());
+            return -1;
+        }
+        catch (std::out_of_range& e)
+        {
+            phosphor::logging::log<phosphor::logging::level::ERR>(e.what());
+            return -1;
         }
     }
-    // As the log files rotate, they are appended with a ".#" that is higher for
-    // the older logs. Since we don't expect more than 10 log files, we
-    // can just sort the list to get them in order from newest to oldest
-    std::sort(selLogFiles.begin(), selLogFiles.end());
-
-    return !selLogFiles.empty();
+    return 0;
 }
 
-static int countSELEntries()
+// Convert an ipmi_sel log line back to the SEL record it was logged for
+static bool selTextToRecord(
+    const std::string& targetEntry, uint32_t timestamp, uint16_t& recordID,
+    uint8_t& recordType,
+    std::array<uint8_t, dynamic_sensors::ipmi::sel::selRecordContentSize>&
+        content)
 {
-    // Get the list of ipmi_sel log files
-    std::vector<std::filesystem::path> selLogFiles;
-    if (!getSELLogFiles(selLogFiles))
+    // The format of the ipmi_sel message is "<Timestamp>
+    // <ID>,<Type>,<EventData>,[<Generator ID>,<Path>,<Direction>]".
+    // The Timestamp was parsed when the entry was indexed
+    size_t space = targetEntry.find_first_of(" ");
+    if (space == std::string::npos)
     {
-        return 0;
+        return false;
+    }
+    // Then get the log contents
+    size_t entryStart = targetEntry.find_first_not_of(" ", space);
+    if (entryStart == std::string::npos)
+    {
+        return false;
+    }
+    std::string_view entry(targetEntry);
+    entry.remove_prefix(entryStart);
+    // Use split to separate the entry into its fields
+    std::vector<std::string> targetEntryFields;
+    boost::split(targetEntryFields, entry, boost::is_any_of(","),
+                 boost::token_compress_on);
+    if (targetEntryFields.size() < 3)
+    {
+        return false;
+    }
+    std::string& recordIDStr = targetEntryFields[0];
+    std::string& recordTypeStr = targetEntryFields[1];
+    std::string& eventDataStr = targetEntryFields[2];
+
+    try
+    {
+        recordID = std::stoul(recordIDStr);
+        recordType = std::stoul(recordTypeStr, nullptr, 16);
+    }
+    catch (const std::invalid_argument&)
+    {
+        return false;
+    }
+    std::vector<uint8_t> eventDataBytes;
+    if (fromHexStr(eventDataStr, eventDataBytes) < 0)
+    {
+        return false;
     }
-    int numSELEntries = 0;
-    // Loop through each log file and count the number of logs
-    for (const std::filesystem::path& file : selLogFiles)
+
+    if (recordType != dynamic_sensors::ipmi::sel::systemEvent)
     {
-        std::ifstream logStream(file);
-        if (!logStream.is_open())
+        return false;
+    }
+
+    // Set the event message revision
+    uint8_t evmRev = dynamic_sensors::ipmi::sel::eventMsgRev;
+
+    uint16_t generatorID = 0;
+    uint8_t sensorType = 0;
+    uint16_t sensorAndLun = 0;
+    uint8_t sensorNum = 0xFF;
+    uint8_t eventType = 0;
+    bool eventDir = 0;
+    // System type events should have six fields
+    if (targetEntryFields.size() >= 6)
+    {
+        std::string& generatorIDStr = targetEntryFields[3];
+        std::string& sensorPath = targetEntryFields[4];
+        std::string& eventDirStr = targetEntryFields[5];
+
+        // Get the generator ID
+        try
         {
-            continue;
+            generatorID = std::stoul(generatorIDStr, nullptr, 16);
+        }
+        catch (const std::invalid_argument&)
+        {
+            std::cerr << "Invalid Generator ID\n";
         }
 
-        std::string line;
-        while (std::getline(logStream, line))
+        // Get the sensor type, sensor number, and event type for the sensor
+        sensorType = getSensorTypeFromPath(sensorPath);
+        sensorAndLun = getSensorNumberFromPath(sensorPath);
+        sensorNum = static_cast<uint8_t>(sensorAndLun);
+        generatorID |= sensorAndLun >> 8;
+        eventType = getSensorEventTypeFromPath(sensorPath);
+
+        // Get the event direction
+        try
+        {
+            eventDir = std::stoul(eventDirStr) ? 0 : 1;
+        }
+        catch (const std::invalid_argument&)
         {
-            numSELEntries++;
+            std::cerr << "Invalid Event Direction\n";
         }
     }
-    return numSELEntries;
+
+    // Only keep the eventData bytes that fit in the record
+    std::array<uint8_t, dynamic_sensors::ipmi::sel::systemEventSize>
+        eventData{};
+    std::copy_n(eventDataBytes.begin(),
+                std::min(eventDataBytes.size(), eventData.size()),
+                eventData.begin());
+
+    // The event direction is bit 7 of the event type byte
+    content = dynamic_sensors::ipmi::sel::systemEventContent(
+        timestamp, generatorID, evmRev, sensorType, sensorNum,
+        (eventType & 0x7f) | (eventDir ? deassertionEvent : 0), eventData);
+    return true;
 }
 
-static bool findSELEntry(const int recordID,
-                         const std::vector<std::filesystem::path>& selLogFiles,
-                         std::string& entry)
+// phosphor-sel-logger logs the BMC's own events with this generator ID, the
+// text to record conversion adds the sensor LUN in the low bits
+static constexpr uint16_t selLoggerGeneratorID = 0x0020;
+static constexpr uint16_t generatorLUNMask = 0x0003;
+
+// Hand a line appended to the ipmi_sel text log to the host's Event Message
+// Buffer, if it is a BMC event. This includes the threshold events, which
+// phosphor-sel-logger logs for the sensor signals.
+static void pushSELTextEvent(
+    const dynamic_sensors::ipmi::sel::SELIndexEntry& indexEntry)
 {
-    // Record ID is the first entry field following the timestamp. It is
-    // preceded by a space and followed by a comma
-    std::string search = " " + std::to_string(recordID) + ",";
+    phosphor::host::event::Buffer& buffer = ipmid_get_host_event_buffer();
+    if (!buffer.enabled())
+    {
+        return;
+    }
 
-    // Loop through the ipmi_sel log entries
-    for (const std::filesystem::path& file : selLogFiles)
+    std::string line;
+    uint16_t recordID;
+    uint8_t recordType;
+    std::array<uint8_t, dynamic_sensors::ipmi::sel::selRecordContentSize>
+        content;
+    if (!selTextIndex().read(indexEntry, line) ||
+        !selTextToRecord(line, indexEntry.timestamp, recordID, recordType,
+                         content))
     {
-        std::ifstream logStream(file);
-        if (!logStream.is_open())
-        {
-            continue;
-        }
+        return;
+    }
+    uint16_t generatorID = content[4] | (content[5] << 8);
+    if ((generatorID & ~generatorLUNMask) != selLoggerGeneratorID)
+    {
+        return;
+    }
 
-        while (std::getline(logStream, entry))
-        {
-            // Check if the record ID matches
-            if (entry.find(search) != std::string::npos)
-            {
-                return true;
-            }
-        }
+    phosphor::host::event::Message message;
+    message[0] = static_cast<uint8_t>(recordID);
+    message[1] = static_cast<uint8_t>(recordID >> 8);
+    message[2] = recordType;
+    std::copy(content.begin(), content.end(), message.begin() + 3);
+    buffer.push(message);
+}
+
+// Refresh the index whenever the ipmi_sel files change, so the BMC events
+// reach the Event Message Buffer without waiting for a SEL command
+static void waitSELText(boost::asio::posix::stream_descriptor& watch)
+{
+    watch.async_wait(boost::asio::posix::stream_descriptor::wait_read,
+                     [&watch](const boost::system::error_code& ec) {
+                         if (ec)
+                         {
+                             return;
+                         }
+                         getSELIndex();
+                         waitSELText(watch);
+                     });
+}
+
+static void watchSELText()
+{
+    dynamic_sensors::ipmi::sel::SELIndex& selIndex = selTextIndex();
+    if (selIndex.watchFd() < 0)
+    {
+        return;
     }
-    return false;
+    // The descriptor closes its own copy
+    int fd = dup(selIndex.watchFd());
+    if (fd < 0)
+    {
+        return;
+    }
+    static boost::asio::posix::stream_descriptor watch(*getIoContext(), fd);
+
+    selIndex.onAppend(pushSELTextEvent);
+    // Index what is there, later lines are reported as appended
+    getSELIndex();
+    waitSELText(watch);
 }
 
-static uint16_t
-    getNextRecordID(const uint16_t recordID,
-                    const std::vector<std::filesystem::path>& selLogFiles)
+// Append the ipmi_sel text log lines the journal does not have yet. Returns
+// the number of records appended.
+static size_t importSELText(dynamic_sensors::ipmi::sel::SELJournal& journal)
 {
-    uint16_t nextRecordID = recordID + 1;
-    std::string entry;
-    if (findSELEntry(nextRecordID, selLogFiles, entry))
+    dynamic_sensors::ipmi::sel::SELIndex& selIndex = getSELIndex();
+    const dynamic_sensors::ipmi::sel::SELIndexEntry* lastEntry =
+        selIndex.highest();
+    if (lastEntry == nullptr)
     {
-        return nextRecordID;
+        return 0;
     }
-    else
+    // The record IDs restart when the text logs are cleared
+    if (lastEntry->recordID < journal.textRecordID())
+    {
+        journal.setTextRecordID(0);
+    }
+    if (lastEntry->recordID == journal.textRecordID())
+    {
+        return 0;
+    }
+
+    size_t imported = 0;
+    for (const dynamic_sensors::ipmi::sel::SELIndexEntry* indexEntry =
+             selIndex.next(journal.textRecordID());
+         indexEntry != nullptr;
+         indexEntry = selIndex.next(indexEntry->recordID))
     {
-        return ipmi::sel::lastEntry;
+        std::string line;
+        uint16_t recordID;
+        uint8_t recordType;
+        std::array<uint8_t, dynamic_sensors::ipmi::sel::selRecordContentSize>
+            content;
+        if (selIndex.read(*indexEntry, line) &&
+            selTextToRecord(line, indexEntry->timestamp, recordID,
+                            recordType, content))
+        {
+            journal.append(recordType, content, indexEntry->timestamp);
+            imported++;
+        }
+        journal.setTextRecordID(indexEntry->recordID);
     }
+    return imported;
 }
 
-static int fromHexStr(const std::string& hexStr, std::vector<uint8_t>& data)
+// The binary SEL journal, or nullptr when the ipmi_sel text logs are used
+static dynamic_sensors::ipmi::sel::SELJournal* getSELJournal()
 {
-    for (unsigned int i = 0; i < hexStr.size(); i += 2)
+#ifdef FEATURE_SEL_JOURNAL
+    static std::unique_ptr<dynamic_sensors::ipmi::sel::SELJournal> journal;
+    static bool opened = false;
+    static uint64_t indexGeneration = 0;
+    if (!opened)
     {
+        opened = true;
         try
         {
-            data.push_back(static_cast<uint8_t>(
-                std::stoul(hexStr.substr(i, 2), nullptr, 16)));
+            journal = std::make_unique<dynamic_sensors::ipmi::sel::SELJournal>(
+                dynamic_sensors::ipmi::sel::selJournalFile);
         }
-        catch (std::invalid_argument& e)
+        catch (const std::exception& e)
         {
-            phosphor::logging::log<phosphor::logging::level::ERR>(e.what());
-            return -1;
+            phosphor::logging::log<phosphor::logging::level::ERR>(
+                "Failed to open the SEL journal, using the text logs",
+                phosphor::logging::entry("WHAT=%s", e.what()));
+            return nullptr;
         }
-        catch (std::out_of_range& e)
+        // Once when opened, for what was logged while ipmid was not running
+        size_t imported = importSELText(*journal);
+        if (journal->created())
         {
-            phosphor::logging::log<phosphor::logging::level::ERR>(e.what());
-            return -1;
+            phosphor::logging::log<phosphor::logging::level::INFO>(
+                "Imported the SEL text logs into the journal",
+                phosphor::logging::entry("IMPORTED=%zu", imported),
+                phosphor::logging::entry("ENTRIES=%zu",
+                                         getSELIndex().size()));
         }
+        indexGeneration = getSELIndex().generation();
     }
-    return 0;
+    // The other daemons keep logging SEL events as text, follow the index
+    // when it picks up new lines
+    if (journal)
+    {
+        const dynamic_sensors::ipmi::sel::SELIndex& selIndex = getSELIndex();
+        if (selIndex.generation() != indexGeneration)
+        {
+            indexGeneration = selIndex.generation();
+            importSELText(*journal);
+        }
+    }
+    return journal.get();
+#else
+    return nullptr;
+#endif
 }
 
 ipmi::RspType<uint8_t,  // SEL version
@@ -866,7 +1182,25 @@ ipmi::RspType<uint8_t,  // SEL version
     ipmiStorageGetSELInfo()
 {
     constexpr uint8_t selVersion = ipmi::sel::selVersion;
-    uint16_t entries = countSELEntries();
+
+    if (dynamic_sensors::ipmi::sel::SELJournal* journal = getSELJournal())
+    {
+        size_t freeSpace = (journal->capacity() - journal->size()) *
+                           dynamic_sensors::ipmi::sel::selRecordSize;
+        uint8_t operationSupport =
+            dynamic_sensors::ipmi::sel::selOperationSupport;
+        if (journal->overflow())
+        {
+            operationSupport |= dynamic_sensors::ipmi::sel::selOverflowFlag;
+        }
+        return ipmi::responseSuccess(
+            selVersion, static_cast<uint16_t>(journal->size()),
+            static_cast<uint16_t>(std::min<size_t>(freeSpace, 0xffff)),
+            journal->addTimestamp(), journal->eraseTimestamp(),
+            operationSupport);
+    }
+
+    uint16_t entries = getSELIndex().size();
     uint32_t addTimeStamp = dynamic_sensors::ipmi::sel::getFileTimestamp(
         dynamic_sensors::ipmi::sel::selLogDir /
         dynamic_sensors::ipmi::sel::selLogFilename);
@@ -880,28 +1214,14 @@ ipmi::RspType<uint8_t,  // SEL version
                                  eraseTimeStamp, operationSupport);
 }
 
-using systemEventType = std::tuple<
-    uint32_t, // Timestamp
-    uint16_t, // Generator ID
-    uint8_t,  // EvM Rev
-    uint8_t,  // Sensor Type
-    uint8_t,  // Sensor Number
-    uint7_t,  // Event Type
-    bool,     // Event Direction
-    std::array<uint8_t, dynamic_sensors::ipmi::sel::systemEventSize>>; // Event
-                                                                       // Data
-using oemTsEventType = std::tuple<
-    uint32_t, // Timestamp
-    std::array<uint8_t, dynamic_sensors::ipmi::sel::oemTsEventSize>>; // Event
-                                                                      // Data
-using oemEventType =
-    std::array<uint8_t, dynamic_sensors::ipmi::sel::oemEventSize>; // Event Data
-
-ipmi::RspType<uint16_t, // Next Record ID
-              uint16_t, // Record ID
-              uint8_t,  // Record Type
-              std::variant<systemEventType, oemTsEventType,
-                           oemEventType>> // Record Content
+// Every record type packs its content as 13 bytes on the wire
+using selRecordContent =
+    std::array<uint8_t, dynamic_sensors::ipmi::sel::selRecordContentSize>;
+
+ipmi::RspType<uint16_t,         // Next Record ID
+              uint16_t,         // Record ID
+              uint8_t,          // Record Type
+              selRecordContent> // Record Content
     ipmiStorageGetSELEntry(uint16_t reservationID, uint16_t targetID,
                            uint8_t offset, uint8_t size)
 {
@@ -922,169 +1242,85 @@ ipmi::RspType<uint16_t, // Next Record ID
         }
     }
 
-    // Get the ipmi_sel log files
-    std::vector<std::filesystem::path> selLogFiles;
-    if (!getSELLogFiles(selLogFiles))
+    if (dynamic_sensors::ipmi::sel::SELJournal* journal = getSELJournal())
     {
-        return ipmi::responseSensorInvalid();
+        // Records are answered straight from the journal mapping
+        const dynamic_sensors::ipmi::sel::SELRecord* record;
+        if (targetID == ipmi::sel::firstEntry)
+        {
+            record = journal->first();
+        }
+        else if (targetID == ipmi::sel::lastEntry)
+        {
+            record = journal->last();
+        }
+        else
+        {
+            record = journal->find(targetID);
+        }
+        if (record == nullptr)
+        {
+            return ipmi::responseSensorInvalid();
+        }
+        const dynamic_sensors::ipmi::sel::SELRecord* next =
+            journal->next(record->recordID);
+        return ipmi::responseSuccess(
+            next != nullptr ? next->recordID : ipmi::sel::lastEntry,
+            record->recordID, record->recordType, record->content);
     }
 
-    std::string targetEntry;
+    dynamic_sensors::ipmi::sel::SELIndex& selIndex = getSELIndex();
+    if (selIndex.files().empty())
+    {
+        return ipmi::responseSensorInvalid();
+    }
 
+    const dynamic_sensors::ipmi::sel::SELIndexEntry* target;
     if (targetID == ipmi::sel::firstEntry)
     {
-        // The first entry will be at the top of the oldest log file
-        std::ifstream logStream(selLogFiles.back());
-        if (!logStream.is_open())
-        {
-            return ipmi::responseUnspecifiedError();
-        }
-
-        if (!std::getline(logStream, targetEntry))
+        target = selIndex.first();
+        if (target == nullptr)
         {
             return ipmi::responseUnspecifiedError();
         }
     }
     else if (targetID == ipmi::sel::lastEntry)
     {
-        // The last entry will be at the bottom of the newest log file
-        std::ifstream logStream(selLogFiles.front());
-        if (!logStream.is_open())
+        target = selIndex.last();
+        if (target == nullptr)
         {
             return ipmi::responseUnspecifiedError();
         }
-
-        std::string line;
-        while (std::getline(logStream, line))
-        {
-            targetEntry = line;
-        }
     }
     else
     {
-        if (!findSELEntry(targetID, selLogFiles, targetEntry))
+        target = selIndex.find(targetID);
+        if (target == nullptr)
         {
             return ipmi::responseSensorInvalid();
         }
     }
 
-    // The format of the ipmi_sel message is "<Timestamp>
-    // <ID>,<Type>,<EventData>,[<Generator ID>,<Path>,<Direction>]".
-    // First get the Timestamp
-    size_t space = targetEntry.find_first_of(" ");
-    if (space == std::string::npos)
-    {
-        return ipmi::responseUnspecifiedError();
-    }
-    std::string entryTimestamp = targetEntry.substr(0, space);
-    // Then get the log contents
-    size_t entryStart = targetEntry.find_first_not_of(" ", space);
-    if (entryStart == std::string::npos)
-    {
-        return ipmi::responseUnspecifiedError();
-    }
-    std::string_view entry(targetEntry);
-    entry.remove_prefix(entryStart);
-    // Use split to separate the entry into its fields
-    std::vector<std::string> targetEntryFields;
-    boost::split(targetEntryFields, entry, boost::is_any_of(","),
-                 boost::token_compress_on);
-    if (targetEntryFields.size() < 3)
+    std::string targetEntry;
+    if (!selIndex.read(*target, targetEntry))
     {
         return ipmi::responseUnspecifiedError();
     }
-    std::string& recordIDStr = targetEntryFields[0];
-    std::string& recordTypeStr = targetEntryFields[1];
-    std::string& eventDataStr = targetEntryFields[2];
 
     uint16_t recordID;
     uint8_t recordType;
-    try
-    {
-        recordID = std::stoul(recordIDStr);
-        recordType = std::stoul(recordTypeStr, nullptr, 16);
-    }
-    catch (const std::invalid_argument&)
-    {
-        return ipmi::responseUnspecifiedError();
-    }
-    uint16_t nextRecordID = getNextRecordID(recordID, selLogFiles);
-    std::vector<uint8_t> eventDataBytes;
-    if (fromHexStr(eventDataStr, eventDataBytes) < 0)
+    selRecordContent content;
+    if (!selTextToRecord(targetEntry, target->timestamp, recordID, recordType,
+                         content))
     {
         return ipmi::responseUnspecifiedError();
     }
+    const dynamic_sensors::ipmi::sel::SELIndexEntry* next =
+        selIndex.next(recordID);
+    uint16_t nextRecordID =
+        next != nullptr ? next->recordID : ipmi::sel::lastEntry;
 
-    if (recordType == dynamic_sensors::ipmi::sel::systemEvent)
-    {
-        // Get the timestamp
-        std::tm timeStruct = {};
-        std::istringstream entryStream(entryTimestamp);
-
-        uint32_t timestamp = ipmi::sel::invalidTimeStamp;
-        if (entryStream >> std::get_time(&timeStruct, "%Y-%m-%dT%H:%M:%S"))
-        {
-            timestamp = std::mktime(&timeStruct);
-        }
-
-        // Set the event message revision
-        uint8_t evmRev = dynamic_sensors::ipmi::sel::eventMsgRev;
-
-        uint16_t generatorID = 0;
-        uint8_t sensorType = 0;
-        uint16_t sensorAndLun = 0;
-        uint8_t sensorNum = 0xFF;
-        uint7_t eventType = 0;
-        bool eventDir = 0;
-        // System type events should have six fields
-        if (targetEntryFields.size() >= 6)
-        {
-            std::string& generatorIDStr = targetEntryFields[3];
-            std::string& sensorPath = targetEntryFields[4];
-            std::string& eventDirStr = targetEntryFields[5];
-
-            // Get the generator ID
-            try
-            {
-                generatorID = std::stoul(generatorIDStr, nullptr, 16);
-            }
-            catch (const std::invalid_argument&)
-            {
-                std::cerr << "Invalid Generator ID\n";
-            }
-
-            // Get the sensor type, sensor number, and event type for the sensor
-            sensorType = getSensorTypeFromPath(sensorPath);
-            sensorAndLun = getSensorNumberFromPath(sensorPath);
-            sensorNum = static_cast<uint8_t>(sensorAndLun);
-            generatorID |= sensorAndLun >> 8;
-            eventType = getSensorEventTypeFromPath(sensorPath);
-
-            // Get the event direction
-            try
-            {
-                eventDir = std::stoul(eventDirStr) ? 0 : 1;
-            }
-            catch (const std::invalid_argument&)
-            {
-                std::cerr << "Invalid Event Direction\n";
-            }
-        }
-
-        // Only keep the eventData bytes that fit in the record
-        std::array<uint8_t, dynamic_sensors::ipmi::sel::systemEventSize>
-            eventData{};
-        std::copy_n(eventDataBytes.begin(),
-                    std::min(eventDataBytes.size(), eventData.size()),
-                    eventData.begin());
-
-        return ipmi::responseSuccess(
-            nextRecordID, recordID, recordType,
-            systemEventType{timestamp, generatorID, evmRev, sensorType,
-                            sensorNum, eventType, eventDir, eventData});
-    }
-
-    return ipmi::responseUnspecifiedError();
+    return ipmi::responseSuccess(nextRecordID, recordID, recordType, content);
 }
 
 ipmi::RspType<uint16_t> ipmiStorageAddSELEntry(
@@ -1098,6 +1334,21 @@ ipmi::RspType<uint16_t> ipmiStorageAddSELEntry(
     cancelSELReservation();
 
     uint16_t responseID = 0xFFFF;
+    if (dynamic_sensors::ipmi::sel::SELJournal* journal = getSELJournal())
+    {
+        // The BMC stamps the records that carry a timestamp
+        uint32_t now = std::time(nullptr);
+        if (recordType < dynamic_sensors::ipmi::sel::oemEventFirst)
+        {
+            timestamp = now;
+        }
+        responseID = journal->append(
+            recordType,
+            dynamic_sensors::ipmi::sel::systemEventContent(
+                timestamp, generatorID, evmRev, sensorType, sensorNum,
+                eventType, {eventData1, eventData2, eventData3}),
+            now);
+    }
     return ipmi::responseSuccess(responseID);
 }
 
@@ -1136,17 +1387,19 @@ ipmi::RspType<uint8_t> ipmiStorageClearSEL(ipmi::Context::ptr ctx,
 
     // Save the erase time
     dynamic_sensors::ipmi::sel::erase_time::save();
+    if (dynamic_sensors::ipmi::sel::SELJournal* journal = getSELJournal())
+    {
+        journal->erase(std::time(nullptr));
+    }
 
     // Clear the SEL by deleting the log files
-    std::vector<std::filesystem::path> selLogFiles;
-    if (getSELLogFiles(selLogFiles))
+    dynamic_sensors::ipmi::sel::SELIndex& selIndex = getSELIndex();
+    for (const std::filesystem::path& file : selIndex.files())
     {
-        for (const std::filesystem::path& file : selLogFiles)
-        {
-            std::error_code ec;
-            std::filesystem::remove(file, ec);
-        }
+        std::error_code ec;
+        std::filesystem::remove(file, ec);
     }
+    selIndex.invalidate();
 
     // Reload rsyslog so it knows to start new log files
     std::shared_ptr<sdbusplus::asio::connection> dbus = getSdBus();
@@ -1244,6 +1497,7 @@ void registerStorageFunctions()
 {
     createTimers();
     startMatch();
+    post_work([]() { watchSELText(); });
 
     // <Get FRU Inventory Area Info>
     ipmi::registerHandler(ipmi::prioOemBase, ipmi::netFnStorage,
@@ -3,6 +3,7 @@
 #include <systemd/sd-bus.h>
 
 #include <array>
+#include <boost/container/flat_map.hpp>
 #include <map>
 #include <string>
 #include <vector>
@@ -33,4 +34,4 @@ struct FruInstance
 using FruInstanceVec = std::vector<FruInstance>;
 
 using FruId = uint32_t;
-using FruMap = std::map<FruId, FruInstanceVec>;
+using FruMap = boost::container::flat_map<FruId, FruInstanceVec>;
@@ -4,6 +4,7 @@
 
 #include "systemintfcmds.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <ipmid/utils.hpp>
 #include <phosphor-logging/elog-errors.hpp>
@@ -24,14 +25,26 @@ constexpr auto HOST_STATE_PATH = "/xyz/openbmc_project/state/host0";
 constexpr auto HOST_STATE_INTERFACE = "xyz.openbmc_project.State.Host";
 constexpr auto HOST_TRANS_PROP = "RequestedHostTransition";
 
-// For throwing exceptions
 using namespace phosphor::logging;
-using InternalFailure =
-    sdbusplus::xyz::openbmc_project::Common::Error::InternalFailure;
 
 namespace sdbusRule = sdbusplus::bus::match::rules;
 
-Manager::Manager(sdbusplus::bus::bus& bus) :
+// Order of the commands in the queue, higher first. Powering the host
+// off should not wait behind anything, a heartbeat can wait for anything
+static int priority(const IpmiCmdData& command)
+{
+    switch (command.first)
+    {
+        case CMD_POWER:
+            return 2;
+        case CMD_HEARTBEAT:
+            return 0;
+        default:
+            return 1;
+    }
+}
+
+Manager::Manager(sdbusplus::asio::connection& bus) :
     bus(bus), timer(std::bind(&Manager::hostTimeout, this)),
     hostTransitionMatch(
         bus,
@@ -62,16 +75,19 @@ IpmiCmdData Manager::getNextCommand()
     }
 
     // Pop the processed entry off the queue
-    auto command = this->workQueue.front();
-    this->workQueue.pop();
+    Pending command = std::move(this->workQueue.front());
+    this->workQueue.pop_front();
+    stats.sent++;
 
-    // IPMI command is the first element in pair
-    auto ipmiCmdData = std::get<0>(command);
+    auto ipmiCmdData = command.command;
 
     // Now, call the user registered functions so that
     // implementation specific CommandComplete signals
     // can be sent. `true` indicating Success.
-    std::get<CallBack>(command)(ipmiCmdData, true);
+    for (const CallBack& callback : command.callbacks)
+    {
+        callback(ipmiCmdData, true);
+    }
 
     // Check for another entry in the queue and kick it off
     this->checkQueueAndAlertHost();
@@ -85,6 +101,7 @@ void Manager::hostTimeout()
 {
     log<level::ERR>("Host control timeout hit!");
 
+    stats.timeouts++;
     clearQueue();
 }
 
@@ -93,18 +110,31 @@ void Manager::clearQueue()
     // Dequeue all entries and send fail signal
     while (!this->workQueue.empty())
     {
-        auto command = this->workQueue.front();
-        this->workQueue.pop();
-
-        // IPMI command is the first element in pair
-        auto ipmiCmdData = std::get<0>(command);
+        Pending command = std::move(this->workQueue.front());
+        this->workQueue.pop_front();
+        stats.failed++;
 
         // Call the implementation specific Command Failure.
         // `false` indicating Failure
-        std::get<CallBack>(command)(ipmiCmdData, false);
+        for (const CallBack& callback : command.callbacks)
+        {
+            callback(command.command, false);
+        }
     }
 }
 
+void setAttention(sdbusplus::asio::connection& bus,
+                  std::function<void(boost::system::error_code)> callback)
+{
+    std::string HOST_IPMI_SVC("org.openbmc.HostIpmi");
+    std::string IPMI_PATH("/org/openbmc/HostIpmi/1");
+    std::string IPMI_INTERFACE("org.openbmc.HostIpmi");
+
+    // Don't hold up the caller, or ipmid, while the bridge sets it
+    bus.async_method_call(std::move(callback), HOST_IPMI_SVC, IPMI_PATH,
+                          IPMI_INTERFACE, "setAttention");
+}
+
 // Called for alerting the host
 void Manager::checkQueueAndAlertHost()
 {
@@ -112,10 +142,6 @@ void Manager::checkQueueAndAlertHost()
     {
         log<level::DEBUG>("Asserting SMS Attention");
 
-        std::string HOST_IPMI_SVC("org.openbmc.HostIpmi");
-        std::string IPMI_PATH("/org/openbmc/HostIpmi/1");
-        std::string IPMI_INTERFACE("org.openbmc.HostIpmi");
-
         // Start the timer for this transaction
         auto time = std::chrono::duration_cast<std::chrono::microseconds>(
             std::chrono::seconds(IPMI_SMS_ATN_ACK_TIMEOUT_SECS));
@@ -127,17 +153,19 @@ void Manager::checkQueueAndAlertHost()
             return;
         }
 
-        auto method =
-            this->bus.new_method_call(HOST_IPMI_SVC.c_str(), IPMI_PATH.c_str(),
-                                      IPMI_INTERFACE.c_str(), "setAttention");
-        auto reply = this->bus.call(method);
-
-        if (reply.is_method_error())
-        {
-            log<level::ERR>("Error in setting SMS attention");
-            elog<InternalFailure>();
-        }
-        log<level::DEBUG>("SMS Attention asserted");
+        setAttention(this->bus, [this](boost::system::error_code ec) {
+            if (ec)
+            {
+                log<level::ERR>("Error in setting SMS attention",
+                                entry("ERROR=%s", ec.message().c_str()));
+                // The host won't come asking, fail the commands now
+                // instead of at the timeout
+                timer.stop();
+                clearQueue();
+                return;
+            }
+            log<level::DEBUG>("SMS Attention asserted");
+        });
     }
 }
 
@@ -147,7 +175,28 @@ void Manager::execute(CommandHandler command)
     log<level::DEBUG>("Pushing cmd on to queue",
                       entry("COMMAND=%d", std::get<0>(command).first));
 
-    this->workQueue.emplace(command);
+    const IpmiCmdData& ipmiCmdData = std::get<IpmiCmdData>(command);
+    auto waiting = std::find_if(
+        this->workQueue.begin(), this->workQueue.end(),
+        [&ipmiCmdData](const Pending& p) { return p.command == ipmiCmdData; });
+    if (waiting != this->workQueue.end())
+    {
+        // Already on its way, the host reading it completes both
+        waiting->callbacks.emplace_back(
+            std::move(std::get<CallBack>(command)));
+        stats.coalesced++;
+        return;
+    }
+
+    // After the commands of the same or higher priority
+    int level = priority(ipmiCmdData);
+    auto pos = std::find_if(
+        this->workQueue.begin(), this->workQueue.end(),
+        [level](const Pending& p) { return priority(p.command) < level; });
+    this->workQueue.insert(
+        pos, Pending{ipmiCmdData, {std::move(std::get<CallBack>(command))}});
+    stats.queued++;
+    stats.maxDepth = std::max(stats.maxDepth, this->workQueue.size());
 
     // Alert host if this is only command in queue otherwise host will
     // be notified of next message after processing the current one
@@ -1,11 +1,14 @@
 #pragma once
 
+#include <cstdint>
+#include <deque>
+#include <functional>
 #include <ipmid-host/cmd-utils.hpp>
-#include <queue>
-#include <sdbusplus/bus.hpp>
+#include <sdbusplus/asio/connection.hpp>
 #include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/timer.hpp>
 #include <tuple>
+#include <vector>
 
 namespace phosphor
 {
@@ -14,12 +17,36 @@ namespace host
 namespace command
 {
 
+/** @brief Asks the host IPMI bridge to set SMS attention
+ *
+ *  @param[in] bus      - dbus handler
+ *  @param[in] callback - called with the result once the bridge answers
+ */
+void setAttention(sdbusplus::asio::connection& bus,
+                  std::function<void(boost::system::error_code)> callback);
+
 /** @class
  *  @brief Manages commands that are to be sent to Host
+ *
+ *  @details Commands wait in priority order, power commands ahead of the
+ *           others and heartbeats last. A command that is already waiting
+ *           is not queued again, the caller's callback is added to it, so
+ *           a burst of identical requests costs one SMS_ATN cycle.
  */
 class Manager
 {
   public:
+    /** @brief Counters of the commands handled, for D-Bus */
+    struct Statistics
+    {
+        uint64_t queued = 0;    //!< Commands queued
+        uint64_t coalesced = 0; //!< Requests added to a waiting command
+        uint64_t sent = 0;      //!< Commands read by the host
+        uint64_t failed = 0;    //!< Commands failed or timed out
+        uint64_t timeouts = 0;  //!< Times the host did not answer
+        size_t maxDepth = 0;    //!< Most commands waiting at once
+    };
+
     Manager() = delete;
     ~Manager() = default;
     Manager(const Manager&) = delete;
@@ -30,9 +57,8 @@ class Manager
     /** @brief Constructs Manager object
      *
      *  @param[in] bus   - dbus handler
-     *  @param[in] event - pointer to sd_event
      */
-    explicit Manager(sdbusplus::bus::bus& bus);
+    explicit Manager(sdbusplus::asio::connection& bus);
 
     /** @brief  Extracts the next entry in the queue and returns
      *          Command and data part of it.
@@ -51,13 +77,40 @@ class Manager
      *
      *  @detail If the queue is empty, then it alerts the Host. If not,
      *          then it returns and the API documented above will handle
-     *          the commands in Queue.
+     *          the commands in Queue. If the same command is already in
+     *          the queue, the callback is added to it instead.
      *
      *  @param[in] command - tuple of <IPMI command, data, callback>
      */
     void execute(CommandHandler command);
 
+    /** @brief Whether no command is waiting for the host */
+    bool empty() const
+    {
+        return workQueue.empty();
+    }
+
+    /** @brief Number of commands waiting for the host */
+    size_t size() const
+    {
+        return workQueue.size();
+    }
+
+    const Statistics& statistics() const
+    {
+        return stats;
+    }
+
   private:
+    /** @brief A command waiting for the host, with the callbacks of
+     *         everyone who asked for it
+     */
+    struct Pending
+    {
+        IpmiCmdData command;
+        std::vector<CallBack> callbacks;
+    };
+
     /** @brief Check if anything in queue and alert host if so */
     void checkQueueAndAlertHost();
 
@@ -95,10 +148,14 @@ class Manager
     void clearQueueOnPowerOn(sdbusplus::message::message& msg);
 
     /** @brief Reference to the dbus handler */
-    sdbusplus::bus::bus& bus;
+    sdbusplus::asio::connection& bus;
+
+    /** @brief Queue to store the requested commands, highest priority
+     *         first
+     */
+    std::deque<Pending> workQueue{};
 
-    /** @brief Queue to store the requested commands */
-    std::queue<CommandHandler> workQueue{};
+    Statistics stats{};
 
     /** @brief Timer for commands to host */
     phosphor::Timer timer;
@@ -0,0 +1,70 @@
+#include "host-event-buffer.hpp"
+
+#include <utility>
+
+namespace phosphor
+{
+namespace host
+{
+namespace event
+{
+
+Buffer::Buffer(Alert alert, size_t capacity) :
+    alert(std::move(alert)), capacity(capacity)
+{
+}
+
+void Buffer::setEnabled(bool enabled)
+{
+    bufferEnabled = enabled;
+    if (!enabled)
+    {
+        messages.clear();
+    }
+}
+
+void Buffer::setFullInterruptEnabled(bool enabled)
+{
+    // Events left from before still need the host's attention
+    if (enabled && !interruptEnabled && !messages.empty() && alert)
+    {
+        alert();
+    }
+    interruptEnabled = enabled;
+}
+
+bool Buffer::push(const Message& message)
+{
+    if (!bufferEnabled)
+    {
+        return false;
+    }
+    if (messages.size() >= capacity)
+    {
+        droppedCount++;
+        return false;
+    }
+    messages.push_back(message);
+    // The host reads until the buffer is empty, so only the first event
+    // needs the attention
+    if (messages.size() == 1 && interruptEnabled && alert)
+    {
+        alert();
+    }
+    return true;
+}
+
+std::optional<Message> Buffer::pop()
+{
+    if (messages.empty())
+    {
+        return std::nullopt;
+    }
+    Message message = messages.front();
+    messages.pop_front();
+    return message;
+}
+
+} // namespace event
+} // namespace host
+} // namespace phosphor
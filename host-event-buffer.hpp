@@ -0,0 +1,116 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <optional>
+
+namespace phosphor
+{
+namespace host
+{
+namespace event
+{
+
+/** @brief An event message, laid out as a SEL event record */
+using Message = std::array<uint8_t, 16>;
+
+/** @class Buffer
+ *  @brief Event Message Buffer read by the host
+ *
+ *  @details Holds the events for system software while the Set BMC Global
+ *           Enables command has the buffer enabled. Unlike the single
+ *           message of the IPMI spec, up to capacity events are kept, and
+ *           the host drains them with Read Event Message Buffer until it
+ *           is answered with 0x80. The host is only alerted when the first
+ *           event goes into an empty buffer, so a burst of events costs one
+ *           attention cycle. Events that find the buffer full are dropped,
+ *           they are still in the SEL.
+ */
+class Buffer
+{
+  public:
+    /** @brief Called to set SMS attention for the host */
+    using Alert = std::function<void()>;
+
+    static constexpr size_t defaultCapacity = 32;
+
+    /** @brief Constructs the buffer, disabled
+     *
+     *  @param[in] alert    - sets SMS attention
+     *  @param[in] capacity - number of events kept
+     */
+    explicit Buffer(Alert alert, size_t capacity = defaultCapacity);
+
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+
+    /** @brief Enables the buffer, disabling it discards the events */
+    void setEnabled(bool enabled);
+    bool enabled() const
+    {
+        return bufferEnabled;
+    }
+
+    /** @brief Enables the alert when events go into an empty buffer */
+    void setFullInterruptEnabled(bool enabled);
+    bool fullInterruptEnabled() const
+    {
+        return interruptEnabled;
+    }
+
+    /** @brief Enables logging of the events received into the SEL. This
+     *         is kept with the buffer as the rest of the BMC Global
+     *         Enables, and checked by the SEL paths.
+     */
+    void setSystemEventLogging(bool enabled)
+    {
+        loggingEnabled = enabled;
+    }
+    bool systemEventLogging() const
+    {
+        return loggingEnabled;
+    }
+
+    /** @brief Adds an event for the host
+     *
+     *  @return false if the buffer is disabled, or full and the event was
+     *          dropped
+     */
+    bool push(const Message& message);
+
+    /** @brief Takes the oldest event, if there is one */
+    std::optional<Message> pop();
+
+    bool empty() const
+    {
+        return messages.empty();
+    }
+    size_t size() const
+    {
+        return messages.size();
+    }
+    // Events dropped because the buffer was full
+    uint64_t dropped() const
+    {
+        return droppedCount;
+    }
+
+  private:
+    Alert alert;
+    size_t capacity;
+    std::deque<Message> messages;
+    bool bufferEnabled = false;
+    bool interruptEnabled = false;
+    bool loggingEnabled = true;
+    uint64_t droppedCount = 0;
+};
+
+} // namespace event
+} // namespace host
+} // namespace phosphor
+
+// The buffer of ipmid, shared by the providers
+extern phosphor::host::event::Buffer& ipmid_get_host_event_buffer();
@@ -0,0 +1,102 @@
+/*
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <boost/container/flat_map.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <variant>
+#include <vector>
+
+namespace dynamic_sensors::ipmi::entity
+{
+
+// Entity-Manager exports the json of a configuration as is, arrays included,
+// so its properties take more types than ::ipmi::Value has
+using Value =
+    std::variant<bool, uint64_t, int64_t, double, std::string,
+                 std::vector<bool>, std::vector<uint64_t>,
+                 std::vector<int64_t>, std::vector<double>,
+                 std::vector<std::string>>;
+
+using PropertyMap = boost::container::flat_map<std::string, Value>;
+using InterfaceMap = boost::container::flat_map<std::string, PropertyMap>;
+
+// EntityId and EntityInstance of one interface, where set
+struct EntityProperties
+{
+    std::optional<uint8_t> entityId;
+    std::optional<uint8_t> entityInstance;
+};
+
+/**
+ * Entity properties of the Entity-Manager objects, by object path.
+ *
+ * Only the interfaces a sensor record takes its entity from are kept: the
+ * Ipmi decorator of a board and the configuration interfaces of the sensors
+ * on it. Filled from one GetManagedObjects and then kept by the signals, so
+ * building a sensor record finds its entity without a D-Bus call.
+ */
+class EntityAssociations
+{
+  public:
+    static constexpr const char* ipmiDecorator =
+        "xyz.openbmc_project.Inventory.Decorator.Ipmi";
+
+    // Add or replace interfaces of an object
+    void addInterfaces(const std::string& path,
+                       const InterfaceMap& interfaces);
+
+    void removeInterfaces(const std::string& path,
+                          const std::vector<std::string>& interfaces);
+
+    // Apply changed properties of an interface already added
+    void updateProperties(const std::string& path,
+                          const std::string& interface,
+                          const PropertyMap& changed);
+
+    /**
+     * Set the entity of a sensor from the board it is associated with, then
+     * from the sensor's own configuration on that board.
+     *
+     * @param[in] board - endpoint of the chassis association of the sensor
+     * @param[in] sensorName - last element of the sensor path
+     * @param[in,out] entityId - left as is unless set by the board or sensor
+     * @param[in,out] entityInstance - as entityId
+     */
+    void lookup(const std::string& board, const std::string& sensorName,
+                uint8_t& entityId, uint8_t& entityInstance) const;
+
+    void clear()
+    {
+        objects.clear();
+    }
+
+    size_t size() const
+    {
+        return objects.size();
+    }
+
+  private:
+    using EntityObject =
+        boost::container::flat_map<std::string, EntityProperties>;
+
+    boost::container::flat_map<std::string, EntityObject> objects;
+};
+
+} // namespace dynamic_sensors::ipmi::entity
@@ -0,0 +1,107 @@
+/*
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <vector>
+
+namespace dynamic_sensors::ipmi::fru
+{
+
+// Raw image of one FRU device, as read with GetRawFru
+struct FruImage
+{
+    uint8_t devId;
+    uint8_t bus;
+    uint8_t addr;
+    // Changed by Write FRU Data and not written back yet
+    bool dirty;
+    // Shared with the Read FRU Data responses
+    std::shared_ptr<std::vector<uint8_t>> data;
+
+    // The data to change, copied first if a response still holds it
+    std::vector<uint8_t>& writable();
+};
+
+/**
+ * Least recently used cache of raw FRU images, by FRU device ID.
+ *
+ * Reading through the FRUs in turn, or several clients reading different
+ * FRUs, then no longer transfers a whole image over D-Bus on every switch
+ * of device. A dirty image is never evicted, it stays until it has been
+ * written back and marked clean.
+ */
+class FruCache
+{
+  public:
+    static constexpr size_t defaultCapacity = 16;
+
+    explicit FruCache(size_t capacity = defaultCapacity);
+
+    FruCache(const FruCache&) = delete;
+    FruCache& operator=(const FruCache&) = delete;
+
+    /** @return the image of this device, now the most recently used, or
+     *          nullptr
+     */
+    FruImage* find(uint8_t devId);
+
+    /** @return the image of this device without touching its use, or
+     *          nullptr
+     */
+    FruImage* peek(uint8_t devId);
+
+    /**
+     * Add or replace the image of a device, evicting the least recently
+     * used clean images beyond the capacity.
+     * @return the cached image
+     */
+    FruImage& insert(uint8_t devId, uint8_t bus, uint8_t addr,
+                     std::vector<uint8_t>&& data);
+
+    void erase(uint8_t devId);
+
+    // Drop the images of a device at this bus and address
+    void eraseDevice(uint8_t bus, uint8_t addr);
+
+    void clear();
+
+    size_t size() const
+    {
+        return lru.size();
+    }
+    size_t capacity() const
+    {
+        return maxImages;
+    }
+
+  private:
+    using List = std::list<FruImage>;
+
+    void evict();
+
+    size_t maxImages;
+    // Most recently used first
+    List lru;
+    std::array<List::iterator, 256> index;
+    std::array<bool, 256> cached{};
+};
+
+} // namespace dynamic_sensors::ipmi::fru
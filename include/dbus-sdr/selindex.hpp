@@ -0,0 +1,179 @@
+/*
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace dynamic_sensors::ipmi::sel
+{
+
+// Same as ipmi::sel::invalidTimeStamp
+static constexpr uint32_t invalidSELTimestamp = 0xFFFFFFFF;
+
+// Where one SEL record lives in the rsyslog files
+struct SELIndexEntry
+{
+    uint16_t recordID = 0;
+    uint16_t file = 0; // index into SELIndex::files(), newest first
+    uint32_t timestamp = 0;
+    uint64_t offset = 0;
+    uint32_t length = 0; // without the newline
+};
+
+/**
+ * Record ID index of the rsyslog SEL files.
+ *
+ * The files are streamed once to find the line of every record. After that
+ * an inotify watch on the log directory tells refresh() what changed:
+ * appends to the live file are indexed incrementally, any rotation,
+ * creation or removal of a SEL file rebuilds the index. Lookups are binary
+ * searches, reading a record is a single pread().
+ */
+class SELIndex
+{
+  public:
+    // Called for each line appended to the live file
+    using AppendHandler = std::function<void(const SELIndexEntry&)>;
+
+    SELIndex(const std::filesystem::path& dir, const std::string& prefix);
+    ~SELIndex();
+
+    SELIndex(const SELIndex&) = delete;
+    SELIndex& operator=(const SELIndex&) = delete;
+
+    /**
+     * Catch up with the changes to the SEL files since the last call. Cheap
+     * when nothing changed. Without an inotify watch, always rebuilds.
+     */
+    void refresh();
+
+    // Forget everything, the next refresh() rebuilds the index
+    void invalidate();
+
+    /**
+     * Have refresh() report the lines appended to the live file, once each
+     * and after they are indexed. The lines found by a rebuild, such as
+     * the ones logged around a rotation, are not reported.
+     */
+    void onAppend(AppendHandler handler)
+    {
+        appendHandler = std::move(handler);
+    }
+
+    // The inotify descriptor, readable when refresh() has work, or -1
+    int watchFd() const
+    {
+        return inotifyFd;
+    }
+
+    // Changes each time refresh() indexes new lines or rebuilds
+    uint64_t generation() const
+    {
+        return updates;
+    }
+
+    /** @return the entry of this record ID, or nullptr */
+    const SELIndexEntry* find(uint16_t recordID) const;
+
+    /** @return the entry following this record ID, or nullptr */
+    const SELIndexEntry* next(uint16_t recordID) const;
+
+    /**
+     * @return the entry of the first line of the oldest file, or nullptr.
+     * Not the lowest record ID: the IDs wrap around. If the ID of that line
+     * was logged again later, the oldest line still indexed.
+     */
+    const SELIndexEntry* first() const
+    {
+        return entries.empty() ? nullptr : find(oldestID);
+    }
+
+    /** @return the entry of the last line of the newest file, or nullptr */
+    const SELIndexEntry* last() const
+    {
+        return entries.empty() ? nullptr : find(newestID);
+    }
+
+    /** @return the entry with the highest record ID, or nullptr */
+    const SELIndexEntry* highest() const
+    {
+        return entries.empty() ? nullptr : &entries.back();
+    }
+
+    /** @return false if the line could not be read back */
+    bool read(const SELIndexEntry& entry, std::string& line) const;
+
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+    bool empty() const
+    {
+        return entries.empty();
+    }
+
+    // The SEL files found by the last rebuild, newest first
+    const std::vector<std::filesystem::path>& files() const
+    {
+        return logFiles;
+    }
+
+  private:
+    // Index the complete lines of a file from offset on, returning the
+    // offset following the last complete line
+    uint64_t indexFile(uint16_t file, uint64_t offset,
+                       std::vector<SELIndexEntry>& found) const;
+    void rebuild();
+    void appendLive();
+    // Find the record IDs of the oldest and the newest line
+    void findEnds();
+    // Drain the inotify events, returning true if a rebuild is needed
+    bool readEvents(bool& liveChanged);
+
+    std::filesystem::path dir;
+    std::string prefix;
+    int inotifyFd = -1;
+    bool stale = true;
+    uint64_t updates = 0;
+
+    std::vector<std::filesystem::path> logFiles;
+    // Sorted by record ID
+    std::vector<SELIndexEntry> entries;
+    uint16_t oldestID = 0;
+    uint16_t newestID = 0;
+    // How far the live file, logFiles[0], has been indexed
+    uint64_t liveIndexed = 0;
+    bool haveLive = false;
+    AppendHandler appendHandler;
+};
+
+/**
+ * Parse the record ID and timestamp of a "<Timestamp> <ID>,<Type>,..." SEL
+ * line. The timestamp is invalidSELTimestamp when it does not parse.
+ * @return false if there is no record ID
+ */
+bool parseSELLine(std::string_view line, uint16_t& recordID,
+                  uint32_t& timestamp);
+
+} // namespace dynamic_sensors::ipmi::sel
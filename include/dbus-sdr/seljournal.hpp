@@ -0,0 +1,133 @@
+/*
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+
+namespace dynamic_sensors::ipmi::sel
+{
+
+static constexpr size_t selRecordSize = 16;
+static constexpr size_t selRecordContentSize = 13;
+
+// One IPMI SEL record, laid out as it goes on the wire
+struct SELRecord
+{
+    uint16_t recordID;
+    uint8_t recordType;
+    std::array<uint8_t, selRecordContentSize> content;
+} __attribute__((packed));
+static_assert(sizeof(SELRecord) == selRecordSize);
+
+/**
+ * Content of a system event record. eventType carries the event direction
+ * in bit 7, as in the Add SEL Entry request.
+ */
+std::array<uint8_t, selRecordContentSize>
+    systemEventContent(uint32_t timestamp, uint16_t generatorID,
+                       uint8_t evmRev, uint8_t sensorType, uint8_t sensorNum,
+                       uint8_t eventType,
+                       const std::array<uint8_t, 3>& eventData);
+
+/**
+ * Binary SEL journal.
+ *
+ * A memory-mapped file of a small header followed by a ring of fixed size
+ * SEL records. Record IDs are handed out in sequence, so a record is found
+ * by its distance from the oldest one, and the handlers read it straight
+ * from the mapping. When the ring is full the oldest record is overwritten
+ * and the overflow flag is set, until the next erase.
+ */
+class SELJournal
+{
+  public:
+    static constexpr uint32_t defaultCapacity = 4096;
+
+    /**
+     * Map the journal file, creating it empty if it does not exist or was
+     * made for another capacity.
+     *
+     * @throws std::system_error if the file cannot be created or mapped
+     * @throws std::invalid_argument if capacity is 0 or would need more
+     *         record IDs than there are
+     */
+    explicit SELJournal(const std::filesystem::path& path,
+                        uint32_t capacity = defaultCapacity);
+    ~SELJournal();
+
+    SELJournal(const SELJournal&) = delete;
+    SELJournal& operator=(const SELJournal&) = delete;
+
+    // The constructor started a new, empty journal
+    bool created() const
+    {
+        return newJournal;
+    }
+
+    /**
+     * Append a record, assigning it the next record ID.
+     * @param[in] timestamp - becomes the last add timestamp
+     * @return the record ID
+     */
+    uint16_t append(uint8_t recordType,
+                    const std::array<uint8_t, selRecordContentSize>& content,
+                    uint32_t timestamp);
+
+    // Drop all records and clear the overflow flag
+    void erase(uint32_t timestamp);
+
+    /**
+     * Record ID of the last ipmi_sel text log line appended, so that lines
+     * logged by the other daemons are added once, also across restarts. 0
+     * when none was, erase() resets it.
+     */
+    uint16_t textRecordID() const;
+    void setTextRecordID(uint16_t recordID);
+
+    /** @return the record with this ID, or nullptr */
+    const SELRecord* find(uint16_t recordID) const;
+
+    /** @return the record following this one, or nullptr */
+    const SELRecord* next(uint16_t recordID) const;
+
+    const SELRecord* first() const;
+    const SELRecord* last() const;
+
+    uint32_t size() const;
+    uint32_t capacity() const;
+    uint32_t addTimestamp() const;
+    uint32_t eraseTimestamp() const;
+    bool overflow() const;
+
+  private:
+    struct Header;
+
+    // Ring position of this record ID, if it is in the journal
+    bool position(uint16_t recordID, uint32_t& distance) const;
+    const SELRecord* at(uint32_t distance) const;
+
+    int fd = -1;
+    void* mapping = nullptr;
+    size_t mapSize = 0;
+    Header* header = nullptr;
+    SELRecord* records = nullptr;
+    bool newJournal = false;
+};
+
+} // namespace dynamic_sensors::ipmi::sel
@@ -124,37 +124,51 @@ SensorSubTree& getSensorTree()
     return sensorTree;
 }
 
-static ipmi_ret_t
-    getSensorConnection(ipmi::Context::ptr ctx, uint16_t sensnum,
-                        std::string& connection, std::string& path,
-                        std::vector<std::string>* interfaces = nullptr)
+// Resolve a sensor number from the request to its sensor index entry.
+// The entry stays valid for as long as the caller holds on to sensorIndex.
+static ipmi_ret_t getSensorEntry(ipmi::Context::ptr ctx, uint16_t sensnum,
+                                 std::shared_ptr<SensorIndex>& sensorIndex,
+                                 const SensorIndexEntry*& entry)
 {
-    auto& sensorTree = getSensorTree();
-    if (!getSensorSubtree(sensorTree) && sensorTree.empty())
+    if (ctx == nullptr)
     {
         return IPMI_CC_RESPONSE_ERROR;
     }
 
-    if (ctx == nullptr)
+    details::getSensorIndex(sensorIndex);
+    if (!sensorIndex || sensorIndex->empty())
     {
         return IPMI_CC_RESPONSE_ERROR;
     }
 
-    path = getPathFromSensorNumber((ctx->lun << 8) | sensnum);
-    if (path.empty())
+    entry =
+        sensorIndex->find(static_cast<uint16_t>((ctx->lun << 8) | sensnum));
+    if (entry == nullptr)
     {
         return IPMI_CC_INVALID_FIELD_REQUEST;
     }
 
-    for (const auto& sensor : sensorTree)
+    return 0;
+}
+
+static ipmi_ret_t
+    getSensorConnection(ipmi::Context::ptr ctx, uint16_t sensnum,
+                        std::string& connection, std::string& path,
+                        std::vector<std::string>* interfaces = nullptr)
+{
+    std::shared_ptr<SensorIndex> sensorIndex;
+    const SensorIndexEntry* entry = nullptr;
+    ipmi_ret_t status = getSensorEntry(ctx, sensnum, sensorIndex, entry);
+    if (status)
+    {
+        return status;
+    }
+
+    connection = entry->service;
+    path = entry->path;
+    if (interfaces)
     {
-        if (path == sensor.first)
-        {
-            connection = sensor.second.begin()->first;
-            if (interfaces)
-                *interfaces = sensor.second.begin()->second;
-            break;
-        }
+        *interfaces = entry->interfaces;
     }
 
     return 0;
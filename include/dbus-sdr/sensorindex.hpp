@@ -0,0 +1,157 @@
+/*
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <dbus-sdr/sensorthresholds.hpp>
+#include <dbus-sdr/sensorutils.hpp>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+static constexpr uint16_t maxSensorsPerLUN = 255;
+static constexpr uint16_t maxIPMISensors = (maxSensorsPerLUN * 3);
+static constexpr uint16_t lun1Sensor0 = 0x100;
+static constexpr uint16_t lun3Sensor0 = 0x300;
+static constexpr uint16_t invalidSensorNumber = 0xFFFF;
+static constexpr uint8_t reservedSensorNumber = 0xFF;
+static constexpr uint16_t noStaticSensor = 0xFFFF;
+
+// Sensor numbers carry the LUN in bits 9:8, so 10 bits cover all of them
+static constexpr size_t sensorNumberSpace = 0x400;
+
+/**
+ * Everything the IPMI handlers need to know about one sensor, resolved once
+ * when the sensor tree is discovered.
+ */
+struct SensorIndexEntry
+{
+    std::string path;
+    std::string service;
+    std::vector<std::string> interfaces;
+    uint16_t sensorNumber = invalidSensorNumber; // LUN in bits 9:8
+    uint16_t recordID = 0;
+
+    // Classified from the path when the entry is added
+    std::string typeString;
+    uint8_t sensorType = 0;
+    uint8_t eventType = 0;
+    std::string sdrId;
+    // Position in the static sensors of sensor-gen.cpp, for hybrid sensors
+    uint16_t staticSensor = noStaticSensor;
+
+    // Filled in on first use, the handlers only see const entries
+    mutable ipmi::SensorAttributesCache attributes;
+    mutable ipmi::SensorThresholdState thresholds;
+};
+
+/**
+ * Dense sensor number index.
+ *
+ * Entries are kept in SDR record order, a flat array indexed by the 10-bit
+ * LUN + sensor number maps to them, and a hash keyed on the (interned) path
+ * answers the reverse direction.
+ */
+class SensorIndex
+{
+  public:
+    SensorIndex();
+
+    // The path hash keys view the entries' own paths, which a copy would
+    // not own. A move keeps the entries where they are.
+    SensorIndex(const SensorIndex&) = delete;
+    SensorIndex& operator=(const SensorIndex&) = delete;
+    SensorIndex(SensorIndex&&) = default;
+    SensorIndex& operator=(SensorIndex&&) = default;
+
+    /**
+     * Reserve room for the expected number of sensors. Appending within the
+     * reserved size never has to rebuild the path hash.
+     */
+    void reserve(size_t count);
+
+    /**
+     * Append a sensor, assigning it the next free sensor number. LUN 2 is
+     * skipped, as in the original numbering scheme.
+     *
+     * @throws std::out_of_range when all IPMI sensor numbers are in use
+     * @return the newly added entry
+     */
+    SensorIndexEntry& append(const std::string& path,
+                             const std::string& service,
+                             const std::vector<std::string>& interfaces);
+
+    /** @return the entry using this LUN + sensor number, or nullptr */
+    const SensorIndexEntry* find(uint16_t sensorNum) const
+    {
+        if (sensorNum >= sensorNumberSpace)
+        {
+            return nullptr;
+        }
+        uint16_t slot = slots[sensorNum];
+        if (slot == invalidSlot)
+        {
+            return nullptr;
+        }
+        return &entries[slot];
+    }
+
+    /** @return the entry for this object path, or nullptr */
+    const SensorIndexEntry* find(std::string_view path) const
+    {
+        auto findPath = pathIndex.find(path);
+        if (findPath == pathIndex.end())
+        {
+            return nullptr;
+        }
+        return &entries[findPath->second];
+    }
+
+    /** @return the entry built for this SDR record ID, or nullptr */
+    const SensorIndexEntry* record(size_t recordID) const
+    {
+        if (recordID >= entries.size())
+        {
+            return nullptr;
+        }
+        return &entries[recordID];
+    }
+
+    size_t size() const
+    {
+        return entries.size();
+    }
+
+    bool empty() const
+    {
+        return entries.empty();
+    }
+
+  private:
+    static constexpr uint16_t invalidSlot = 0xFFFF;
+
+    // Rebuild the path hash, needed if growing entries moved the strings
+    void reindexPaths();
+
+    std::vector<SensorIndexEntry> entries;
+    std::array<uint16_t, sensorNumberSpace> slots;
+    // Keys view entries[n].path, so each path string is only stored once
+    std::unordered_map<std::string_view, uint16_t> pathIndex;
+    uint16_t nextSensorNumber = 0;
+};
@@ -0,0 +1,203 @@
+/*
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <dbus-sdr/sensorindex.hpp>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace details
+{
+// Default for the runtime toggle of the stats instrumentation
+static constexpr bool enableInstrumentation = false;
+
+/**
+ * Power of two histogram. Bucket n counts the values below 2^n units, the
+ * last bucket everything larger. Percentiles resolve to the upper bound of
+ * a bucket, which is precise enough to spot a slow sensor service.
+ */
+class StatsHistogram
+{
+  public:
+    static constexpr size_t bucketCount = 24;
+
+    void record(uint64_t value);
+
+    /** @return the bucket bound the percentile falls under, 0 if empty */
+    uint64_t percentile(unsigned int percent) const;
+
+    uint32_t count() const
+    {
+        return total;
+    }
+
+  private:
+    std::array<uint32_t, bucketCount> buckets{};
+    uint32_t total = 0;
+};
+
+class IPMIStatsEntry
+{
+  private:
+    uint32_t numReadings = 0;
+    uint32_t numMissings = 0;
+    uint32_t numStreakRead = 0;
+    uint32_t numStreakMiss = 0;
+    double minValue = 0.0;
+    double maxValue = 0.0;
+    uint16_t sensorNumber = invalidSensorNumber;
+    std::string sensorName;
+    std::string sensorPath;
+    // Time to get the sensor map, in microseconds
+    StatsHistogram readLatency;
+    // Age of the cached sensor map when it was read, in milliseconds
+    StatsHistogram cacheAge;
+
+  public:
+    explicit IPMIStatsEntry(std::string_view path);
+
+    const std::string& getName(void) const
+    {
+        return sensorName;
+    }
+
+    void updateName(std::string_view name)
+    {
+        sensorName = name;
+    }
+
+    const std::string& getPath(void) const
+    {
+        return sensorPath;
+    }
+
+    uint16_t getSensorNumber(void) const
+    {
+        return sensorNumber;
+    }
+
+    void updateSensorNumber(uint16_t number)
+    {
+        sensorNumber = number;
+    }
+
+    uint32_t getReadings(void) const
+    {
+        return numReadings;
+    }
+
+    uint32_t getMissings(void) const
+    {
+        return numMissings;
+    }
+
+    uint32_t getStreakRead(void) const
+    {
+        return numStreakRead;
+    }
+
+    uint32_t getStreakMiss(void) const
+    {
+        return numStreakMiss;
+    }
+
+    double getMin(void) const
+    {
+        return minValue;
+    }
+
+    double getMax(void) const
+    {
+        return maxValue;
+    }
+
+    const StatsHistogram& getReadLatency(void) const
+    {
+        return readLatency;
+    }
+
+    const StatsHistogram& getCacheAge(void) const
+    {
+        return cacheAge;
+    }
+
+    // Returns true if this is the first successful reading
+    // This is so the caller can log the coefficients used
+    bool updateReading(double reading, int raw);
+
+    void updateTiming(std::chrono::microseconds readTime,
+                      std::chrono::milliseconds age);
+};
+
+/**
+ * Per-sensor read statistics, switched on and off at runtime.
+ *
+ * Entries are keyed by sensor path, so they carry over when the SDR is
+ * regenerated and sensor numbers move. Everything runs on the ipmid
+ * io_context thread, so the table takes no locks.
+ */
+class IPMIStatsTable
+{
+  private:
+    bool statsEnabled = enableInstrumentation;
+    std::vector<IPMIStatsEntry> entries;
+    std::map<std::string, size_t, std::less<>> pathIndex;
+
+    IPMIStatsEntry& findEntry(std::string_view path);
+
+  public:
+    bool enabled(void) const
+    {
+        return statsEnabled;
+    }
+
+    void setEnabled(bool enable)
+    {
+        statsEnabled = enable;
+    }
+
+    // The SDR is being regenerated. Sensor numbers are forgotten until the
+    // new records are built, the statistics stay with their sensor paths.
+    void wipeTable(void);
+
+    // Drop all statistics
+    void clear(void);
+
+    const std::string& getName(std::string_view path);
+
+    void updateName(std::string_view path, uint16_t sensorNumber,
+                    std::string_view name);
+
+    bool updateReading(std::string_view path, double reading, int raw);
+
+    void updateTiming(std::string_view path,
+                      std::chrono::microseconds readTime,
+                      std::chrono::milliseconds age);
+
+    const std::vector<IPMIStatsEntry>& getEntries(void) const
+    {
+        return entries;
+    }
+};
+
+} // namespace details
@@ -0,0 +1,116 @@
+/*
+// Copyright (c) 2018 Intel Corporation
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//      http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+*/
+
+#pragma once
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace ipmi
+{
+
+static constexpr const char* warningThresholdInterface =
+    "xyz.openbmc_project.Sensor.Threshold.Warning";
+static constexpr const char* criticalThresholdInterface =
+    "xyz.openbmc_project.Sensor.Threshold.Critical";
+
+enum class ThresholdLevel : size_t
+{
+    warningHigh,
+    warningLow,
+    criticalHigh,
+    criticalLow,
+};
+
+static constexpr size_t thresholdLevels = 4;
+
+// Level of a Threshold value property, e.g. "WarningHigh"
+std::optional<ThresholdLevel> getThresholdLevel(std::string_view property);
+
+// Level of a Threshold alarm property, e.g. "WarningAlarmLow"
+std::optional<ThresholdLevel> getAlarmLevel(std::string_view property);
+
+/**
+ * Threshold and alarm state of one sensor.
+ *
+ * Filled in once from the sensor map, then kept current by the
+ * PropertiesChanged signals of the Threshold.Warning/Critical and the VR
+ * mode interfaces, so the sensor commands can answer from it directly.
+ * The sensor range follows the sensor maps read for the reading and SDR.
+ */
+struct SensorThresholdState
+{
+    bool populated = false;
+
+    bool hasWarning = false;
+    bool hasCritical = false;
+
+    // MaxValue/MinValue of Sensor.Value, before widening by the thresholds.
+    // Refreshed from the sensor map on every reading and SDR read.
+    double maxValue = 127;
+    double minValue = -128;
+
+    std::array<std::optional<double>, thresholdLevels> thresholds;
+    std::array<bool, thresholdLevels> alarms{};
+    // An assert was signalled, so a later clear counts as a deassertion
+    std::array<bool, thresholdLevels> asserted{};
+
+    // VoltageRegulatorMode profiles and the selected one, for VR sensors
+    bool isVr = false;
+    std::vector<std::string> vrProfiles;
+    std::string vrSelected;
+
+    /**
+     * Apply a threshold value property, e.g. "WarningHigh".
+     * @return false if this is not a threshold value property
+     */
+    bool updateThreshold(std::string_view property, double value);
+
+    /**
+     * Apply an alarm property, e.g. "CriticalAlarmLow". Only alarms that
+     * arrive as signals (event is true) feed the deassertion tracking.
+     * @return false if this is not an alarm property
+     */
+    bool updateAlarm(std::string_view property, bool value, bool event);
+
+    const std::optional<double>& threshold(ThresholdLevel level) const
+    {
+        return thresholds[static_cast<size_t>(level)];
+    }
+
+    bool alarm(ThresholdLevel level) const
+    {
+        return alarms[static_cast<size_t>(level)];
+    }
+
+    // The alarm was asserted and has since cleared
+    bool deasserted(ThresholdLevel level) const
+    {
+        size_t index = static_cast<size_t>(level);
+        return asserted[index] && !alarms[index];
+    }
+
+    // Same as getSensorMaxMin() on the sensor map this state came from
+    void getMaxMin(double& max, double& min) const;
+
+    // Index of the selected VR profile, if it is one of the supported ones
+    std::optional<size_t> vrProfileIndex() const;
+};
+
+} // namespace ipmi
@@ -17,6 +17,8 @@
 #pragma once
 #include <algorithm>
 #include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
 
 namespace ipmi
@@ -36,4 +38,36 @@ uint8_t scaleIPMIValueFromDouble(const double value, const int16_t mValue,
 
 uint8_t getScaledIPMIValue(const double value, const double max,
                            const double min);
+
+// The linearization coefficients for one sensor, see getSensorAttributes()
+struct SensorAttributes
+{
+    int16_t mValue = 0;
+    int8_t rExp = 0;
+    int16_t bValue = 0;
+    int8_t bExp = 0;
+    bool bSigned = false;
+};
+
+// Solving for the coefficients takes a few iterative loops, but they only
+// depend on min and max. Keep the last result and only solve again when
+// either of them changes.
+class SensorAttributesCache
+{
+  public:
+    // Returns nullptr if no coefficients can represent this range
+    const SensorAttributes* get(const double max, const double min);
+
+    void invalidate()
+    {
+        solved = false;
+    }
+
+  private:
+    bool solved = false;
+    bool valid = false;
+    double cachedMax = 0.0;
+    double cachedMin = 0.0;
+    SensorAttributes attributes;
+};
 } // namespace ipmi
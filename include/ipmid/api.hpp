@@ -36,6 +36,9 @@ std::shared_ptr<boost::asio::io_context> getIoContext();
 // any client can interact with the main sdbus
 std::shared_ptr<sdbusplus::asio::connection> getSdBus();
 
+// any client can add its D-Bus interfaces to the main object server
+std::shared_ptr<sdbusplus::asio::object_server> getObjectServer();
+
 /**
  * @brief post some work to the async exection queue
  *
@@ -266,6 +266,21 @@ struct PackSingle<std::string_view>
     }
 };
 
+/** @brief Specialization of PackSingle for ipmi::SharedBytes */
+template <>
+struct PackSingle<SharedBytes>
+{
+    static int op(Payload& p, const SharedBytes& t)
+    {
+        if (p.bitCount != 0)
+        {
+            return 1;
+        }
+        p.raw.insert(p.raw.end(), t.data(), t.data() + t.size());
+        return 0;
+    }
+};
+
 /** @brief Specialization of PackSingle for std::variant<T, N> */
 template <typename... T>
 struct PackSingle<std::variant<T...>>
@@ -18,7 +18,9 @@
 #include <bitset>
 #include <boost/multiprecision/cpp_int.hpp>
 #include <ipmid/utility.hpp>
+#include <memory>
 #include <tuple>
+#include <vector>
 
 // unsigned fixed-bit sizes
 template <unsigned N>
@@ -72,6 +74,43 @@ using int24_t = fixed_int_t<24>;
 // bool is more efficient than a uint1_t
 using bit = bool;
 
+namespace ipmi
+{
+
+/**
+ * @brief A range of bytes in a shared buffer, for a response
+ *
+ * The bytes are packed straight from the buffer into the response payload,
+ * without a vector of their own first. The buffer is held until then, so
+ * its owner may drop or replace it meanwhile.
+ */
+class SharedBytes
+{
+  public:
+    SharedBytes(std::shared_ptr<const std::vector<uint8_t>> buffer,
+                size_t offset, size_t length) :
+        buffer(std::move(buffer)),
+        offset(offset), length(length)
+    {
+    }
+
+    const uint8_t* data() const
+    {
+        return buffer->data() + offset;
+    }
+    size_t size() const
+    {
+        return length;
+    }
+
+  private:
+    std::shared_ptr<const std::vector<uint8_t>> buffer;
+    size_t offset;
+    size_t length;
+};
+
+} // namespace ipmi
+
 // Mechanism for going from uint7_t, int7_t, or std::bitset<7> to 7 bits
 // use nrFixedBits<uint7_t> or nrFixedBits<decltype(u7)>
 namespace types
@@ -15,6 +15,7 @@ enum Cmd
     i2cCmd = 2,
     flashCmd = 3,
     fanManualCmd = 4,
+    getMultipleSensorReadingsCmd = 5,
     ethStatsCmd = 48,
     blobTransferCmd = 128,
 };
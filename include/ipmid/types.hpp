@@ -3,6 +3,9 @@
 #include <openssl/crypto.h>
 #include <stdint.h>
 
+#include <array>
+#include <boost/container/flat_map.hpp>
+#include <limits>
 #include <map>
 #include <sdbusplus/server.hpp>
 #include <string>
@@ -68,7 +71,7 @@ struct PreReqValues
     Value deassert; // Value in case of deassert.
 };
 
-using PreReqOffsetValueMap = std::map<Offset, PreReqValues>;
+using PreReqOffsetValueMap = boost::container::flat_map<Offset, PreReqValues>;
 
 /**
  * @struct SetSensorReadingReq
@@ -114,13 +117,15 @@ struct GetSensorResponse
     uint8_t discreteReadingSensorStates; // discrete-only, optional states
 };
 
-using OffsetValueMap = std::map<Offset, Values>;
+using OffsetValueMap = boost::container::flat_map<Offset, Values>;
 
 using DbusPropertyValues = std::pair<PreReqOffsetValueMap, OffsetValueMap>;
 
-using DbusPropertyMap = std::map<DbusProperty, DbusPropertyValues>;
+using DbusPropertyMap =
+    boost::container::flat_map<DbusProperty, DbusPropertyValues>;
 
-using DbusInterfaceMap = std::map<DbusInterface, DbusPropertyMap>;
+using DbusInterfaceMap =
+    boost::container::flat_map<DbusInterface, DbusPropertyMap>;
 
 using InstancePath = std::string;
 using Type = uint8_t;
@@ -180,7 +185,15 @@ struct Info
 };
 
 using Id = uint8_t;
-using IdInfoMap = std::map<Id, Info>;
+// The generated tables are sorted arrays, built in one allocation each and
+// searched without chasing tree nodes
+using IdInfoMap = boost::container::flat_map<Id, Info>;
+
+// Position of each sensor number in the generated IdInfoMap, generated with
+// it so that a lookup by number is an index instead of a search
+using IdPositionMap =
+    std::array<uint16_t, std::numeric_limits<Id>::max() + 1>;
+static constexpr uint16_t noIdPosition = std::numeric_limits<uint16_t>::max();
 
 using PropertyMap = ipmi::PropertyMap;
 
@@ -201,7 +214,7 @@ struct SelData
 
 using InventoryPath = std::string;
 
-using InvObjectIDMap = std::map<InventoryPath, SelData>;
+using InvObjectIDMap = boost::container::flat_map<InventoryPath, SelData>;
 
 enum class ThresholdMask
 {
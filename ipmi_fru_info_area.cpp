@@ -7,6 +7,7 @@
 #include <numeric>
 #include <phosphor-logging/elog.hpp>
 #include <sstream>
+#include <string_view>
 
 namespace ipmi
 {
@@ -152,6 +153,57 @@ void appendChassisType(const PropertyMap& propMap, FruAreaData& data)
     data.emplace_back(chassisType);
 }
 
+/**
+ * @brief The part of a property value that goes in the FRU area data
+ *
+ * @param[in] value property value
+ * @return value without a 0x prefix, trimmed to the field length
+ */
+std::string_view fieldValue(std::string_view value)
+{
+    // If starts with 0x or 0X remove them
+    // ex: 0x123a just take 123a
+    if ((value.compare(0, 2, "0x")) == 0 || (value.compare(0, 2, "0X") == 0))
+    {
+        value.remove_prefix(2);
+    }
+
+    // 6 bits for length as per FRU spec v1.0
+    // if length is greater then 63(2^6) bytes then trim the data to 63
+    // bytess.
+    return value.substr(0, maxRecordAttributeValue);
+}
+
+/**
+ * @brief Size of a property value appended by appendData
+ *
+ * @param[in] key key to search for in the property inventory data
+ * @param[in] propMap map of property values
+ * @return size in bytes, with the type/length byte
+ */
+size_t dataSize(const Property& key, const PropertyMap& propMap)
+{
+    auto iter = propMap.find(key);
+    if (iter == propMap.end())
+    {
+        return 1;
+    }
+    return 1 + fieldValue(iter->second).size();
+}
+
+/**
+ * @brief Size of an info area once padded and checksummed
+ *
+ * @param[in] length size of the formatted fields
+ * @return size in bytes
+ */
+size_t areaSize(size_t length)
+{
+    length += checksumSize;
+    return (length + recordUnitOfMeasurement - 1) / recordUnitOfMeasurement *
+           recordUnitOfMeasurement;
+}
+
 /**
  * @brief Read property value from inventory and append to the FRU area data
  *
@@ -165,28 +217,13 @@ void appendData(const Property& key, const PropertyMap& propMap,
     auto iter = propMap.find(key);
     if (iter != propMap.end())
     {
-        auto value = iter->second;
-        // If starts with 0x or 0X remove them
-        // ex: 0x123a just take 123a
-        if ((value.compare(0, 2, "0x")) == 0 ||
-            (value.compare(0, 2, "0X") == 0))
-        {
-            value.erase(0, 2);
-        }
-
-        // 6 bits for length as per FRU spec v1.0
-        // if length is greater then 63(2^6) bytes then trim the data to 63
-        // bytess.
-        auto valueLength = (value.length() > maxRecordAttributeValue)
-                               ? maxRecordAttributeValue
-                               : value.length();
+        auto value = fieldValue(iter->second);
         // 2 bits for type
         // Set the type to ascii
-        uint8_t typeLength = valueLength | ipmi::fru::typeASCII;
+        uint8_t typeLength = value.size() | ipmi::fru::typeASCII;
 
         data.emplace_back(typeLength);
-        std::copy(value.begin(), value.begin() + valueLength,
-                  std::back_inserter(data));
+        data.insert(data.end(), value.begin(), value.end());
     }
     else
     {
@@ -298,6 +335,10 @@ FruAreaData buildChassisInfoArea(const PropertyMap& propMap)
     FruAreaData fruAreaData;
     if (!propMap.empty())
     {
+        // Header, type, two fields and the end of custom fields
+        fruAreaData.reserve(areaSize(2 + 1 + dataSize(modelNumber, propMap) +
+                                     dataSize(serialNumber, propMap) + 1));
+
         // Set formatting data that goes at the beginning of the record
         preFormatProcessing(false, fruAreaData);
 
@@ -330,6 +371,12 @@ FruAreaData buildBoardInfoArea(const PropertyMap& propMap)
     FruAreaData fruAreaData;
     if (!propMap.empty())
     {
+        // Header, date, four fields, the file ID and the end of custom fields
+        fruAreaData.reserve(areaSize(
+            3 + manufacturingDateSize + dataSize(manufacturer, propMap) +
+            dataSize(prettyName, propMap) + dataSize(serialNumber, propMap) +
+            dataSize(partNumber, propMap) + 3));
+
         preFormatProcessing(true, fruAreaData);
 
         // Manufacturing date
@@ -372,6 +419,13 @@ FruAreaData buildProductInfoArea(const PropertyMap& propMap)
     FruAreaData fruAreaData;
     if (!propMap.empty())
     {
+        // Header, five fields, the asset tag, the file ID and the end of
+        // custom fields
+        fruAreaData.reserve(areaSize(
+            3 + dataSize(manufacturer, propMap) +
+            dataSize(prettyName, propMap) + dataSize(modelNumber, propMap) +
+            dataSize(version, propMap) + dataSize(serialNumber, propMap) + 4));
+
         // Set formatting data that goes at the beginning of the record
         preFormatProcessing(true, fruAreaData);
 
@@ -407,9 +461,44 @@ FruAreaData buildProductInfoArea(const PropertyMap& propMap)
     return fruAreaData;
 }
 
-FruAreaData buildFruAreaData(const FruInventoryData& inventory)
+using AreaEncoder = FruAreaData (*)(const PropertyMap&);
+
+// The section and the encoder of each info area, in the order of the data
+static const std::array<std::pair<const char*, AreaEncoder>,
+                        FruAreaBuilder::areaCount>
+    areaEncoders = {{{chassis, buildChassisInfoArea},
+                     {board, buildBoardInfoArea},
+                     {product, buildProductInfoArea}}};
+
+void FruAreaBuilder::invalidate(const Section& section)
+{
+    for (size_t area = 0; area < areaCount; area++)
+    {
+        if (section == areaEncoders[area].first)
+        {
+            stale.set(area);
+        }
+    }
+}
+
+FruAreaData FruAreaBuilder::build(const FruInventoryData& inventory)
 {
+    size_t fruSize = commonHeaderFormatSize;
+    for (size_t area = 0; area < areaCount; area++)
+    {
+        if (stale.test(area))
+        {
+            auto it = inventory.find(areaEncoders[area].first);
+            areas[area] = (it != inventory.end())
+                              ? areaEncoders[area].second(it->second)
+                              : FruAreaData{};
+        }
+        fruSize += areas[area].size();
+    }
+    stale.reset();
+
     FruAreaData combFruArea{};
+    combFruArea.reserve(std::max<size_t>(fruSize, fruMinSize));
     // Now build common header with data for this FRU Inv Record
     // Use this variable to increment size of header as we go along to determine
     // offset for the subsequent area offsets
@@ -420,35 +509,11 @@ FruAreaData buildFruAreaData(const FruInventoryData& inventory)
     // 2nd byte is offset to internal use data
     combFruArea.emplace_back(recordNotPresent);
 
-    // 3rd byte is offset to chassis data
-    FruAreaData chassisArea;
-    auto chassisIt = inventory.find(chassis);
-    if (chassisIt != inventory.end())
-    {
-        chassisArea = buildChassisInfoArea(chassisIt->second);
-    }
-    // update the offset to chassis data.
-    buildCommonHeaderSection(chassisArea.size(), curDataOffset, combFruArea);
-
-    // 4th byte is offset to board data
-    FruAreaData boardArea;
-    auto boardIt = inventory.find(board);
-    if (boardIt != inventory.end())
+    // 3rd to 5th bytes are the offsets to chassis, board and product data
+    for (const auto& area : areas)
     {
-        boardArea = buildBoardInfoArea(boardIt->second);
+        buildCommonHeaderSection(area.size(), curDataOffset, combFruArea);
     }
-    // update the offset to the board data.
-    buildCommonHeaderSection(boardArea.size(), curDataOffset, combFruArea);
-
-    // 5th byte is offset to product data
-    FruAreaData prodArea;
-    auto prodIt = inventory.find(product);
-    if (prodIt != inventory.end())
-    {
-        prodArea = buildProductInfoArea(prodIt->second);
-    }
-    // update the offset to the product data.
-    buildCommonHeaderSection(prodArea.size(), curDataOffset, combFruArea);
 
     // 6th byte is offset to multirecord data
     combFruArea.emplace_back(recordNotPresent);
@@ -460,15 +525,10 @@ FruAreaData buildFruAreaData(const FruInventoryData& inventory)
     appendDataChecksum(combFruArea);
 
     // Combine everything into one full IPMI FRU specification Record
-    // add chassis use area data
-    combFruArea.insert(combFruArea.end(), chassisArea.begin(),
-                       chassisArea.end());
-
-    // add board area data
-    combFruArea.insert(combFruArea.end(), boardArea.begin(), boardArea.end());
-
-    // add product use area data
-    combFruArea.insert(combFruArea.end(), prodArea.begin(), prodArea.end());
+    for (const auto& area : areas)
+    {
+        combFruArea.insert(combFruArea.end(), area.begin(), area.end());
+    }
 
     // If area is smaller than the minimum size, pad it. This enables ipmitool
     // to update the FRU blob with values longer than the original payload.
@@ -480,5 +540,10 @@ FruAreaData buildFruAreaData(const FruInventoryData& inventory)
     return combFruArea;
 }
 
+FruAreaData buildFruAreaData(const FruInventoryData& inventory)
+{
+    return FruAreaBuilder().build(inventory);
+}
+
 } // namespace fru
 } // namespace ipmi
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <array>
+#include <bitset>
 #include <map>
 #include <string>
 #include <vector>
@@ -24,5 +26,39 @@ using FruInventoryData = std::map<Section, PropertyMap>;
  */
 FruAreaData buildFruAreaData(const FruInventoryData& inventory);
 
+/**
+ * @brief Builds Fru area data from separately encoded info areas
+ *
+ * The chassis, board and product areas are each kept as encoded. After a
+ * change to one section only its area is encoded again, the common header
+ * offsets are worked out when the data is assembled.
+ */
+class FruAreaBuilder
+{
+  public:
+    /**
+     * @brief Encode the area of a section again on the next build
+     *
+     * @param[in] section - section with changed properties
+     */
+    void invalidate(const Section& section);
+
+    /**
+     * @brief Encode the invalidated areas and assemble the FRU area data
+     *
+     * @param[in] inventory - FRU properties values read from inventory
+     *
+     * @return FruAreaData FRU area data as per IPMI specification
+     */
+    FruAreaData build(const FruInventoryData& inventory);
+
+    static constexpr size_t areaCount = 3;
+
+  private:
+    // Chassis, board and product areas, in the order of the data
+    std::array<FruAreaData, areaCount> areas;
+    std::bitset<areaCount> stale = std::bitset<areaCount>().set();
+};
+
 } // namespace fru
 } // namespace ipmi
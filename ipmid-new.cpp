@@ -28,6 +28,7 @@
 #include <filesystem>
 #include <forward_list>
 #include <host-cmd-manager.hpp>
+#include <host-event-buffer.hpp>
 #include <ipmid-host/cmd.hpp>
 #include <ipmid/api.hpp>
 #include <ipmid/handler.hpp>
@@ -818,10 +819,19 @@ std::unique_ptr<phosphor::host::command::Manager>& ipmid_get_host_cmd_manager()
     return cmdManager;
 }
 
+// Event Message Buffer, setting SMS attention as the command manager does
+std::unique_ptr<phosphor::host::event::Buffer> eventBuffer;
+phosphor::host::event::Buffer& ipmid_get_host_event_buffer()
+{
+    return *eventBuffer;
+}
+
 // These are symbols that are present in libipmid, but not expected
 // to be used except here (or maybe a unit test), so declare them here
 extern void setIoContext(std::shared_ptr<boost::asio::io_context>& newIo);
 extern void setSdBus(std::shared_ptr<sdbusplus::asio::connection>& newBus);
+extern void setObjectServer(
+    std::shared_ptr<sdbusplus::asio::object_server>& newServer);
 
 int main(int argc, char* argv[])
 {
@@ -838,6 +848,9 @@ int main(int argc, char* argv[])
     }
     auto sdbusp = std::make_shared<sdbusplus::asio::connection>(*io, bus);
     setSdBus(sdbusp);
+    // Before the providers load, they add their interfaces to it
+    auto server = std::make_shared<sdbusplus::asio::object_server>(sdbusp);
+    setObjectServer(server);
 
     // TODO: Hack to keep the sdEvents running.... Not sure why the sd_event
     //       queue stops running if we don't have a timer that keeps re-arming
@@ -849,6 +862,16 @@ int main(int argc, char* argv[])
     sdbusplus::asio::sd_event_wrapper sdEvents(*io);
 
     cmdManager = std::make_unique<phosphor::host::command::Manager>(*sdbusp);
+    eventBuffer = std::make_unique<phosphor::host::event::Buffer>([sdbusp]() {
+        phosphor::host::command::setAttention(
+            *sdbusp, [](boost::system::error_code ec) {
+                if (ec)
+                {
+                    log<level::ERR>("Error in setting SMS attention",
+                                    entry("ERROR=%s", ec.message().c_str()));
+                }
+            });
+    });
 
     // Register all command providers and filters
     std::forward_list<ipmi::IpmiProvider> providers =
@@ -886,12 +909,25 @@ int main(int argc, char* argv[])
 
     sdbusp->request_name("xyz.openbmc_project.Ipmi.Host");
     // Add bindings for inbound IPMI requests
-    auto server = sdbusplus::asio::object_server(sdbusp);
-    auto iface = server.add_interface("/xyz/openbmc_project/Ipmi",
-                                      "xyz.openbmc_project.Ipmi.Server");
+    auto iface = server->add_interface("/xyz/openbmc_project/Ipmi",
+                                       "xyz.openbmc_project.Ipmi.Server");
     iface->register_method("execute", ipmi::executionEntry);
     iface->initialize();
 
+    // Statistics of the commands sent to the host: waiting now, most
+    // waiting at once, queued, coalesced, sent, failed and timeouts
+    auto hostCmdIface =
+        server->add_interface("/xyz/openbmc_project/Ipmi/HostCommands",
+                              "xyz.openbmc_project.Ipmi.HostCommands");
+    hostCmdIface->register_method("GetStatistics", []() {
+        const auto& stats = cmdManager->statistics();
+        return std::make_tuple(
+            static_cast<uint32_t>(cmdManager->size()),
+            static_cast<uint32_t>(stats.maxDepth), stats.queued,
+            stats.coalesced, stats.sent, stats.failed, stats.timeouts);
+    });
+    hostCmdIface->initialize();
+
     io->run();
 
     // destroy all the IPMI handlers so the providers can unload safely
@@ -899,6 +935,9 @@ int main(int argc, char* argv[])
     ipmi::groupHandlerMap.clear();
     ipmi::oemHandlerMap.clear();
     ipmi::filterList.clear();
+    // and the provider interfaces held by the object server
+    server.reset();
+    setObjectServer(server);
     // unload the provider libraries
     providers.clear();
 
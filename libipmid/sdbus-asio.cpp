@@ -1,12 +1,14 @@
 #include <boost/asio/io_context.hpp>
 #include <memory>
 #include <sdbusplus/asio/connection.hpp>
+#include <sdbusplus/asio/object_server.hpp>
 
 namespace
 {
 
 std::shared_ptr<boost::asio::io_context> ioCtx;
 std::shared_ptr<sdbusplus::asio::connection> sdbusp;
+std::shared_ptr<sdbusplus::asio::object_server> objServer;
 
 } // namespace
 
@@ -29,3 +31,14 @@ std::shared_ptr<sdbusplus::asio::connection> getSdBus()
 {
     return sdbusp;
 }
+
+void setObjectServer(
+    std::shared_ptr<sdbusplus::asio::object_server>& newServer)
+{
+    objServer = newServer;
+}
+
+std::shared_ptr<sdbusplus::asio::object_server> getObjectServer()
+{
+    return objServer;
+}
@@ -3,12 +3,18 @@
 #include "fruread.hpp"
 
 #include <algorithm>
+#include <array>
+#include <bitset>
+#include <boost/asio/spawn.hpp>
 #include <ipmid/api.hpp>
 #include <ipmid/types.hpp>
 #include <ipmid/utils.hpp>
 #include <map>
 #include <phosphor-logging/elog-errors.hpp>
 #include <sdbusplus/message/types.hpp>
+#include <set>
+#include <tuple>
+#include <unordered_map>
 #include <xyz/openbmc_project/Common/error.hpp>
 
 extern const FruMap frus;
@@ -20,7 +26,7 @@ namespace fru
 using namespace phosphor::logging;
 using InternalFailure =
     sdbusplus::xyz::openbmc_project::Common::Error::InternalFailure;
-std::unique_ptr<sdbusplus::bus::match_t> matchPtr
+std::vector<std::unique_ptr<sdbusplus::bus::match_t>> matches
     __attribute__((init_priority(101)));
 
 namespace cache
@@ -31,48 +37,245 @@ namespace cache
 // Caching the data which will be invalidated when ever there
 // is a change in FRU properties.
 FRUAreaMap fruMap;
+// The inventory properties each area was built from. A property change is
+// applied here and the area rebuilt without reading the inventory again.
+std::map<FRUId, FruInventoryData> inventory;
+// The encoded info areas of each FRU, so a change re-encodes only the area
+// of the changed section
+std::map<FRUId, FruAreaBuilder> builders;
+// Presence of each FRU, from the Present property of its first instance.
+// Seeded by the prefetch or the first query, then kept by the signals.
+std::bitset<256> present;
+std::bitset<256> presenceKnown;
+// Count of the changes seen for each FRU. A read of the inventory yields,
+// and a change that comes meanwhile finds nothing cached to apply to yet:
+// the read compares the counts to know its values may be older.
+std::array<uint32_t, 256> changes{};
 } // namespace cache
+
+namespace
+{
+
+// A property of an inventory object that a FRU area field is built from
+struct MappedProperty
+{
+    FRUId fruId;
+    const IPMIFruData* fruData;
+    // Other properties of the FRU map to the same field and the first one
+    // read wins, so a change can't be applied on its own
+    bool shared;
+};
+
+using PropertyIndex = std::map<DbusProperty, std::vector<MappedProperty>>;
+using InterfaceIndex = std::map<DbusInterface, PropertyIndex>;
+using PathIndex = std::unordered_map<std::string, InterfaceIndex>;
+
+std::string inventoryPath(const std::string& path)
+{
+    // Is the path the full dbus path?
+    if (path.find(xyzPrefix) != std::string::npos)
+    {
+        return path;
+    }
+    return invObjPath + path;
+}
+
+/**
+ * @brief Index of the FRU map by inventory object path
+ *
+ * Built once, so a property change signal costs one lookup instead of a
+ * scan through all the FRUs.
+ *
+ * @return properties of each object path mapped into FRU areas
+ */
+const PathIndex& pathIndex()
+{
+    static const PathIndex index = []() {
+        PathIndex index;
+        std::map<std::tuple<FRUId, std::string, std::string>, size_t> fields;
+        for (const auto& [fruId, instanceList] : frus)
+        {
+            for (const auto& instance : instanceList)
+            {
+                auto& interfaces = index[inventoryPath(instance.path)];
+                for (const auto& [intf, properties] : instance.interfaces)
+                {
+                    for (const auto& [name, fruData] : properties)
+                    {
+                        interfaces[intf][name].push_back(
+                            {static_cast<FRUId>(fruId), &fruData, false});
+                        fields[{static_cast<FRUId>(fruId), fruData.section,
+                                fruData.property}]++;
+                    }
+                }
+            }
+        }
+        for (auto& [path, interfaces] : index)
+        {
+            for (auto& [intf, properties] : interfaces)
+            {
+                for (auto& [name, mapped] : properties)
+                {
+                    for (auto& property : mapped)
+                    {
+                        property.shared =
+                            fields[{property.fruId, property.fruData->section,
+                                    property.fruData->property}] > 1;
+                    }
+                }
+            }
+        }
+        return index;
+    }();
+    return index;
+}
+
+void invalidate(FRUId fruId)
+{
+    cache::changes[fruId]++;
+    cache::fruMap.erase(fruId);
+    cache::inventory.erase(fruId);
+    cache::builders.erase(fruId);
+}
+
+/**
+ * @brief Index of the FRUs by the object path their presence is read from
+ *
+ * @return FRU ids of each object path
+ */
+const std::unordered_map<std::string, std::vector<FRUId>>& presenceIndex()
+{
+    static const auto index = []() {
+        std::unordered_map<std::string, std::vector<FRUId>> index;
+        for (const auto& [fruId, instanceList] : frus)
+        {
+            if (!instanceList.empty())
+            {
+                index[inventoryPath(instanceList[0].path)].push_back(
+                    static_cast<FRUId>(fruId));
+            }
+        }
+        return index;
+    }();
+    return index;
+}
+
+void updatePresence(FRUId fruId, bool present)
+{
+    // The FRU was removed or put back, and may not be the same one
+    if (cache::presenceKnown.test(fruId) &&
+        cache::present.test(fruId) != present)
+    {
+        invalidate(fruId);
+    }
+    cache::present.set(fruId, present);
+    cache::presenceKnown.set(fruId);
+}
+
+/**
+ * @brief Apply a changed inventory property to the cached FRU data
+ *
+ * @param[in] property - the FRU field the property maps to
+ * @param[in] value - the new value, or nullptr if not a string
+ */
+void updateProperty(const MappedProperty& property, const std::string* value)
+{
+    cache::changes[property.fruId]++;
+    auto inventory = cache::inventory.find(property.fruId);
+    if (inventory == cache::inventory.end())
+    {
+        return;
+    }
+    if (value == nullptr || property.shared)
+    {
+        invalidate(property.fruId);
+        return;
+    }
+
+    const auto& fruData = *property.fruData;
+    auto section = inventory->second.find(fruData.section);
+    if (section != inventory->second.end())
+    {
+        auto field = section->second.find(fruData.property);
+        if (field != section->second.end() && field->second == *value)
+        {
+            return;
+        }
+    }
+    inventory->second[fruData.section][fruData.property] = *value;
+    // Rebuilt from the cached properties on the next read
+    cache::fruMap.erase(property.fruId);
+    cache::builders[property.fruId].invalidate(fruData.section);
+}
+
+/**
+ * @brief Add the properties of an interface that map into the FRU area
+ *
+ * @param[in,out] data - FRU inventory data
+ * @param[in] mapped - the properties mapped into the FRU area
+ * @param[in] allProp - all the properties of the interface
+ */
+void addProperties(FruInventoryData& data, const DbusPropertyVec& mapped,
+                   const ipmi::PropertyMap& allProp)
+{
+    for (auto& properties : mapped)
+    {
+        auto iter = allProp.find(properties.first);
+        if (iter != allProp.end())
+        {
+            data[properties.second.section].emplace(
+                properties.second.property,
+                std::get<std::string>(iter->second));
+        }
+    }
+}
+
+} // namespace
+
 /**
  * @brief Read all the property value's for the specified interface
  *  from Inventory.
  *
+ * @param[in] ctx IPMI context to yield on
  * @param[in] intf Interface
  * @param[in] path Object path
  * @return map of properties
  */
-ipmi::PropertyMap readAllProperties(const std::string& intf,
+ipmi::PropertyMap readAllProperties(ipmi::Context::ptr ctx,
+                                    const std::string& intf,
                                     const std::string& path)
 {
     ipmi::PropertyMap properties;
-    sdbusplus::bus::bus bus{ipmid_get_sd_bus_connection()};
     std::string service;
     std::string objPath;
+    boost::system::error_code ec;
 
     // Is the path the full dbus path?
     if (path.find(xyzPrefix) != std::string::npos)
     {
-        service = ipmi::getService(bus, intf, path);
+        ec = ipmi::getService(ctx, intf, path, service);
         objPath = path;
     }
     else
     {
-        service = ipmi::getService(bus, invMgrInterface, invObjPath);
+        ec = ipmi::getService(ctx, invMgrInterface, invObjPath, service);
         objPath = invObjPath + path;
     }
-
-    auto method = bus.new_method_call(service.c_str(), objPath.c_str(),
-                                      propInterface, "GetAll");
-    method.append(intf);
-    try
+    if (ec)
     {
-        auto reply = bus.call(method);
-        reply.read(properties);
+        log<level::ERR>("Failed to find the inventory service",
+                        entry("ERROR=%s", ec.message().c_str()),
+                        entry("INTERFACE=%s", intf.c_str()),
+                        entry("PATH=%s", objPath.c_str()));
+        elog<InternalFailure>();
     }
-    catch (const sdbusplus::exception::SdBusError& e)
+
+    ec = ipmi::getAllDbusProperties(ctx, service, objPath, intf, properties);
+    if (ec)
     {
         // If property is not found simply return empty value
         log<level::ERR>("Error in reading property values",
-                        entry("EXCEPTION=%s", e.what()),
+                        entry("ERROR=%s", ec.message().c_str()),
                         entry("INTERFACE=%s", intf.c_str()),
                         entry("PATH=%s", objPath.c_str()));
     }
@@ -82,26 +285,98 @@ ipmi::PropertyMap readAllProperties(const std::string& intf,
 
 void processFruPropChange(sdbusplus::message::message& msg)
 {
-    if (cache::fruMap.empty())
+    const auto& index = pathIndex();
+    auto object = index.find(msg.get_path());
+    if (object == index.end())
     {
         return;
     }
-    std::string path = msg.get_path();
-    // trim the object base path, if found at the beginning
-    if (path.compare(0, strlen(invObjPath), invObjPath) == 0)
+
+    std::string intf;
+    ipmi::PropertyMap changed;
+    std::vector<std::string> invalidated;
+    try
     {
-        path.erase(0, strlen(invObjPath));
+        msg.read(intf, changed, invalidated);
     }
-    for (const auto& [fruId, instanceList] : frus)
+    catch (const sdbusplus::exception::SdBusError& e)
     {
-        auto found = std::find_if(
-            instanceList.begin(), instanceList.end(),
-            [&path](const auto& iter) { return (iter.path == path); });
+        log<level::ERR>("Error in reading property change",
+                        entry("EXCEPTION=%s", e.what()),
+                        entry("PATH=%s", msg.get_path()));
+        auto presence = presenceIndex().find(object->first);
+        if (presence != presenceIndex().end())
+        {
+            for (auto fruId : presence->second)
+            {
+                cache::presenceKnown.reset(fruId);
+            }
+        }
+        for (const auto& [name, properties] : object->second)
+        {
+            for (const auto& [property, mapped] : properties)
+            {
+                for (const auto& field : mapped)
+                {
+                    invalidate(field.fruId);
+                }
+            }
+        }
+        return;
+    }
 
-        if (found != instanceList.end())
+    if (intf == invItemInterface)
+    {
+        auto present = changed.find(itemPresentProp);
+        auto presence = presenceIndex().find(object->first);
+        if (present != changed.end() && presence != presenceIndex().end())
+        {
+            const auto* value = std::get_if<bool>(&present->second);
+            for (auto fruId : presence->second)
+            {
+                if (value)
+                {
+                    updatePresence(fruId, *value);
+                }
+                else
+                {
+                    cache::presenceKnown.reset(fruId);
+                }
+            }
+        }
+    }
+
+    if (cache::inventory.empty())
+    {
+        return;
+    }
+    auto properties = object->second.find(intf);
+    if (properties == object->second.end())
+    {
+        return;
+    }
+    for (const auto& [name, value] : changed)
+    {
+        auto mapped = properties->second.find(name);
+        if (mapped == properties->second.end())
+        {
+            continue;
+        }
+        for (const auto& field : mapped->second)
+        {
+            updateProperty(field, std::get_if<std::string>(&value));
+        }
+    }
+    for (const auto& name : invalidated)
+    {
+        auto mapped = properties->second.find(name);
+        if (mapped == properties->second.end())
         {
-            cache::fruMap.erase(fruId);
-            break;
+            continue;
+        }
+        for (const auto& field : mapped->second)
+        {
+            invalidate(field.fruId);
         }
     }
 }
@@ -109,15 +384,30 @@ void processFruPropChange(sdbusplus::message::message& msg)
 // register for fru property change
 int registerCallbackHandler()
 {
-    if (matchPtr == nullptr)
+    if (matches.empty())
     {
         using namespace sdbusplus::bus::match::rules;
         sdbusplus::bus::bus bus{ipmid_get_sd_bus_connection()};
-        matchPtr = std::make_unique<sdbusplus::bus::match_t>(
-            bus,
-            path_namespace(invObjPath) + type::signal() +
-                member("PropertiesChanged") + interface(propInterface),
-            std::bind(processFruPropChange, std::placeholders::_1));
+
+        // Only the interfaces with properties in the FRU areas, and the
+        // presence, so the bus doesn't wake us for the rest of the inventory
+        std::set<std::string> interfaces{invItemInterface};
+        for (const auto& [path, object] : pathIndex())
+        {
+            for (const auto& [intf, properties] : object)
+            {
+                interfaces.insert(intf);
+            }
+        }
+        for (const auto& intf : interfaces)
+        {
+            matches.emplace_back(std::make_unique<sdbusplus::bus::match_t>(
+                bus,
+                path_namespace(invObjPath) + type::signal() +
+                    member("PropertiesChanged") + interface(propInterface) +
+                    argN(0, intf),
+                std::bind(processFruPropChange, std::placeholders::_1)));
+        }
     }
     return 0;
 }
@@ -125,10 +415,12 @@ int registerCallbackHandler()
 /**
  * @brief Read FRU property values from Inventory
  *
+ * @param[in] ctx IPMI context to yield on
  * @param[in] fruNum  FRU id
  * @return populate FRU Inventory data
  */
-FruInventoryData readDataFromInventory(const FRUId& fruNum)
+FruInventoryData readDataFromInventory(ipmi::Context::ptr ctx,
+                                       const FRUId& fruNum)
 {
     auto iter = frus.find(fruNum);
     if (iter == frus.end())
@@ -144,36 +436,197 @@ FruInventoryData readDataFromInventory(const FRUId& fruNum)
         for (auto& intf : instance.interfaces)
         {
             ipmi::PropertyMap allProp =
-                readAllProperties(intf.first, instance.path);
-            for (auto& properties : intf.second)
-            {
-                auto iter = allProp.find(properties.first);
-                if (iter != allProp.end())
-                {
-                    data[properties.second.section].emplace(
-                        properties.second.property,
-                        std::move(
-                            std::get<std::string>(allProp[properties.first])));
-                }
-            }
+                readAllProperties(ctx, intf.first, instance.path);
+            addProperties(data, intf.second, allProp);
         }
     }
     return data;
 }
 
-const FruAreaData& getFruAreaData(const FRUId& fruNum)
+std::shared_ptr<const FruAreaData> getFruAreaData(ipmi::Context::ptr ctx,
+                                                  const FRUId& fruNum)
 {
     auto iter = cache::fruMap.find(fruNum);
     if (iter != cache::fruMap.end())
     {
         return iter->second;
     }
-    auto invData = readDataFromInventory(fruNum);
+    auto inventory = cache::inventory.find(fruNum);
+    if (inventory == cache::inventory.end())
+    {
+        // Read again when the FRU changed during the read
+        static constexpr int maxReads = 3;
+        FruInventoryData data;
+        bool changed = true;
+        for (int read = 0; changed && read < maxReads; read++)
+        {
+            uint32_t changes = cache::changes[fruNum];
+            data = readDataFromInventory(ctx, fruNum);
+            changed = changes != cache::changes[fruNum];
+        }
+        if (changed)
+        {
+            // Still changing, answer this read without caching it
+            return std::make_shared<const FruAreaData>(
+                buildFruAreaData(data));
+        }
+
+        // Other commands run while this one yields, and may have read it
+        inventory = cache::inventory.emplace(fruNum, std::move(data)).first;
+        iter = cache::fruMap.find(fruNum);
+        if (iter != cache::fruMap.end())
+        {
+            return iter->second;
+        }
+    }
 
     // Build area info based on inventory data
-    FruAreaData newdata = buildFruAreaData(std::move(invData));
-    cache::fruMap.emplace(fruNum, std::move(newdata));
-    return cache::fruMap.at(fruNum);
+    auto newdata = std::make_shared<const FruAreaData>(
+        cache::builders[fruNum].build(inventory->second));
+    return cache::fruMap.emplace(fruNum, std::move(newdata)).first->second;
+}
+
+bool isFruPresent(ipmi::Context::ptr ctx, const FRUId& fruNum)
+{
+    if (cache::presenceKnown.test(fruNum))
+    {
+        return cache::present.test(fruNum);
+    }
+
+    auto iter = frus.find(fruNum);
+    if (iter == frus.end() || iter->second.empty())
+    {
+        log<level::ERR>("Unsupported FRU ID ", entry("FRUID=%d", fruNum));
+        elog<InternalFailure>();
+    }
+
+    bool present = false;
+    auto ec = ipmi::getDbusProperty(ctx, invMgrInterface,
+                                    inventoryPath(iter->second[0].path),
+                                    invItemInterface, itemPresentProp, present);
+    if (ec)
+    {
+        log<level::ERR>("Failed to read the FRU presence",
+                        entry("FRUID=%d", fruNum),
+                        entry("ERROR=%s", ec.message().c_str()));
+        elog<InternalFailure>();
+    }
+    // A signal may have set it while this read yielded
+    if (!cache::presenceKnown.test(fruNum))
+    {
+        updatePresence(fruNum, present);
+    }
+    return cache::present.test(fruNum);
+}
+
+void prefetchFruAreas()
+{
+    boost::asio::spawn(*getIoContext(), [](boost::asio::yield_context yield) {
+        auto bus = getSdBus();
+        boost::system::error_code ec;
+        auto services = bus->yield_method_call<
+            std::map<std::string, std::vector<std::string>>>(
+            yield, ec, "xyz.openbmc_project.ObjectMapper",
+            "/xyz/openbmc_project/object_mapper",
+            "xyz.openbmc_project.ObjectMapper", "GetObject",
+            std::string(invObjPath),
+            std::vector<std::string>({invMgrInterface}));
+        if (ec || services.empty())
+        {
+            log<level::ERR>("Failed to find the inventory manager",
+                            entry("ERROR=%s", ec.message().c_str()));
+            return;
+        }
+
+        // One call for the whole inventory instead of a GetAll for each
+        // interface of each FRU instance. A FRU that changes meanwhile is
+        // left to the first read.
+        auto changes = cache::changes;
+        auto objects = bus->yield_method_call<ipmi::ObjectValueTree>(
+            yield, ec, services.begin()->first, invObjPath,
+            "org.freedesktop.DBus.ObjectManager", "GetManagedObjects");
+        if (ec)
+        {
+            log<level::ERR>("Failed to read the inventory",
+                            entry("ERROR=%s", ec.message().c_str()));
+            return;
+        }
+
+        for (const auto& [path, fruIds] : presenceIndex())
+        {
+            auto object = objects.find(sdbusplus::message::object_path(path));
+            if (object == objects.end())
+            {
+                continue;
+            }
+            auto item = object->second.find(invItemInterface);
+            if (item == object->second.end())
+            {
+                continue;
+            }
+            auto present = item->second.find(itemPresentProp);
+            if (present == item->second.end())
+            {
+                continue;
+            }
+            if (const auto* value = std::get_if<bool>(&present->second))
+            {
+                for (auto fruId : fruIds)
+                {
+                    updatePresence(fruId, *value);
+                }
+            }
+        }
+
+        for (const auto& [fruId, instanceList] : frus)
+        {
+            auto fruNum = static_cast<FRUId>(fruId);
+            if (cache::inventory.find(fruNum) != cache::inventory.end() ||
+                changes[fruNum] != cache::changes[fruNum])
+            {
+                continue;
+            }
+
+            // A FRU with an instance elsewhere is left to the first read
+            FruInventoryData data;
+            bool complete = true;
+            try
+            {
+                for (const auto& instance : instanceList)
+                {
+                    auto object = objects.find(sdbusplus::message::object_path(
+                        inventoryPath(instance.path)));
+                    if (object == objects.end())
+                    {
+                        complete = false;
+                        break;
+                    }
+                    for (const auto& intf : instance.interfaces)
+                    {
+                        auto allProp = object->second.find(intf.first);
+                        if (allProp != object->second.end())
+                        {
+                            addProperties(data, intf.second, allProp->second);
+                        }
+                    }
+                }
+            }
+            catch (const std::bad_variant_access& e)
+            {
+                complete = false;
+            }
+            if (!complete)
+            {
+                continue;
+            }
+
+            auto& inventory =
+                cache::inventory.emplace(fruNum, std::move(data)).first->second;
+            cache::fruMap.emplace(
+                fruNum, std::make_shared<const FruAreaData>(
+                            cache::builders[fruNum].build(inventory)));
+        }
+    });
 }
 } // namespace fru
 } // namespace ipmi
@@ -1,6 +1,8 @@
 #pragma once
 #include "ipmi_fru_info_area.hpp"
 
+#include <ipmid/api.hpp>
+#include <memory>
 #include <sdbusplus/bus.hpp>
 #include <string>
 
@@ -9,7 +11,8 @@ namespace ipmi
 namespace fru
 {
 using FRUId = uint8_t;
-using FRUAreaMap = std::map<FRUId, FruAreaData>;
+// The areas are shared with the responses that read them
+using FRUAreaMap = std::map<FRUId, std::shared_ptr<const FruAreaData>>;
 
 static constexpr auto xyzPrefix = "/xyz/openbmc_project/";
 static constexpr auto invMgrInterface = "xyz.openbmc_project.Inventory.Manager";
@@ -21,11 +24,24 @@ static constexpr auto itemPresentProp = "Present";
 /**
  * @brief Get fru area data as per IPMI specification
  *
+ * @param[in] ctx IPMI context, the inventory is read yielding on it when
+ *            the FRU is not cached
  * @param[in] fruNum FRU ID
  *
  * @return FRU area data as per IPMI specification
  */
-const FruAreaData& getFruAreaData(const FRUId& fruNum);
+std::shared_ptr<const FruAreaData> getFruAreaData(ipmi::Context::ptr ctx,
+                                                  const FRUId& fruNum);
+
+/**
+ * @brief Get the presence of a FRU
+ *
+ * @param[in] ctx IPMI context, as for getFruAreaData
+ * @param[in] fruNum FRU ID
+ *
+ * @return true if the FRU is present
+ */
+bool isFruPresent(ipmi::Context::ptr ctx, const FRUId& fruNum);
 
 /**
  * @brief Register callback handler into DBUS for PropertyChange events
@@ -33,5 +49,11 @@ const FruAreaData& getFruAreaData(const FRUId& fruNum);
  * @return negative value on failure
  */
 int registerCallbackHandler();
+
+/**
+ * @brief Read the inventory in the background and build the FRU areas
+ *        ahead of the first FRU command
+ */
+void prefetchFruAreas();
 } // namespace fru
 } // namespace ipmi
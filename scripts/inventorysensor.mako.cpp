@@ -6,8 +6,9 @@
 #include <ipmid/types.hpp>
 using namespace ipmi::sensor;
 
-extern const InvObjectIDMap invSensors = {
-% for key in sensorDict.keys():
+## The keys are emitted in order, so the table is taken as it is
+extern const InvObjectIDMap invSensors(boost::container::ordered_unique_range, {
+% for key in sorted(sensorDict.keys()):
    % if key:
 {"${key}",
     {
@@ -23,5 +24,5 @@ extern const InvObjectIDMap invSensors = {
 },
    % endif
 % endfor
-};
+});
 
@@ -2,8 +2,9 @@
 #include <iostream>
 #include "fruread.hpp"
 
-extern const FruMap frus = {
-% for key in fruDict.keys():
+## The keys are emitted in order, so the table is taken as it is
+extern const FruMap frus(boost::container::ordered_unique_range, {
+% for key in sorted(fruDict.keys()):
    {${key},{
 <%
     instanceList = fruDict[key]
@@ -39,4 +40,4 @@ extern const FruMap frus = {
     % endfor
    }},
 % endfor
-};
+});
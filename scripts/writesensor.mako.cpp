@@ -32,8 +32,9 @@ sensorNameMaxLength = 16
 namespace ipmi {
 namespace sensor {
 
-extern const IdInfoMap sensors = {
-% for key in sensorDict.keys():
+## The keys are emitted in order, so the table is taken as it is
+extern const IdInfoMap sensors(boost::container::ordered_unique_range, {
+% for key in sorted(sensorDict.keys()):
    % if key:
 {${key},{
 <%
@@ -174,7 +175,18 @@ except KeyError:
 }},
    % endif
 % endfor
-};
+});
+
+<%
+ids = [key for key in sorted(sensorDict.keys()) if key]
+positions = {key: position for position, key in enumerate(ids)}
+%>\
+extern const IdPositionMap sensorPositions = {{
+% for row in range(0, 256, 8):
+    ${", ".join(str(positions[id]) if id in positions else "noIdPosition"
+                for id in range(row, row + 8))},
+% endfor
+}};
 
 } // namespace sensor
 } // namespace ipmi
@@ -0,0 +1,86 @@
+#include "selqueue.hpp"
+
+#include <boost/asio/post.hpp>
+#include <exception>
+#include <utility>
+
+namespace ipmi
+{
+
+namespace sel
+{
+
+SELQueue::SELQueue(boost::asio::io_context& io, size_t capacity,
+                   size_t batchSize) :
+    io(io),
+    maxDepth(capacity), batchSize(batchSize == 0 ? 1 : batchSize)
+{
+}
+
+bool SELQueue::push(Write&& write)
+{
+    if (depth() >= maxDepth)
+    {
+        droppedCount++;
+        return false;
+    }
+    pending.emplace_back(std::move(write));
+    if (depth() > highWaterMark)
+    {
+        highWaterMark = depth();
+    }
+    schedule();
+    return true;
+}
+
+void SELQueue::schedule()
+{
+    if (scheduled || pending.empty() || outstanding >= batchSize)
+    {
+        return;
+    }
+    scheduled = true;
+    boost::asio::post(io, [this]() { drain(); });
+}
+
+void SELQueue::drain()
+{
+    scheduled = false;
+    // Writes that complete inline free their slot at once, so also bound
+    // the number started here to keep this turn of the io_context short
+    for (size_t started = 0;
+         started < batchSize && outstanding < batchSize && !pending.empty();
+         started++)
+    {
+        Write write = std::move(pending.front());
+        pending.pop_front();
+        outstanding++;
+        try
+        {
+            write([this](bool success) { complete(success); });
+        }
+        catch (const std::exception&)
+        {
+            complete(false);
+        }
+    }
+    schedule();
+}
+
+void SELQueue::complete(bool success)
+{
+    outstanding--;
+    if (success)
+    {
+        writtenCount++;
+    }
+    else
+    {
+        failedCount++;
+    }
+    schedule();
+}
+
+} // namespace sel
+
+} // namespace ipmi
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <boost/asio/io_context.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+
+namespace ipmi
+{
+
+namespace sel
+{
+
+/**
+ * @class SELQueue
+ * @brief Queue of SEL writes requested by the host.
+ *
+ * Add SEL Entry and Platform Event answer the host as soon as their write
+ * is queued. The queued writes are started from the io_context, up to
+ * batchSize per turn and with at most batchSize outstanding. Each write is
+ * still its own asynchronous logging call; the queue only keeps a burst of
+ * events off the host's path and bounds the calls in flight. A write
+ * counts as written or failed once its call answers. When capacity writes
+ * are queued or outstanding, push() fails and the handler answers Node
+ * Busy.
+ */
+class SELQueue
+{
+  public:
+    using Done = std::function<void(bool success)>;
+    // Starts one write, and calls done once it is persisted or has failed
+    using Write = std::function<void(Done done)>;
+
+    static constexpr size_t defaultCapacity = 256;
+    static constexpr size_t defaultBatchSize = 16;
+
+    SELQueue(boost::asio::io_context& io, size_t capacity = defaultCapacity,
+             size_t batchSize = defaultBatchSize);
+
+    SELQueue(const SELQueue&) = delete;
+    SELQueue& operator=(const SELQueue&) = delete;
+
+    /** @brief Queue a write
+     *
+     *  @return false, and the write is dropped, if the queue is full
+     */
+    bool push(Write&& write);
+
+    /** @brief Writes queued or outstanding */
+    size_t depth() const
+    {
+        return pending.size() + outstanding;
+    }
+    size_t capacity() const
+    {
+        return maxDepth;
+    }
+    // Deepest the queue has been
+    size_t highWater() const
+    {
+        return highWaterMark;
+    }
+    // Writes refused because the queue was full
+    uint64_t dropped() const
+    {
+        return droppedCount;
+    }
+    uint64_t written() const
+    {
+        return writtenCount;
+    }
+    uint64_t failed() const
+    {
+        return failedCount;
+    }
+
+  private:
+    void schedule();
+    void drain();
+    void complete(bool success);
+
+    boost::asio::io_context& io;
+    size_t maxDepth;
+    size_t batchSize;
+    std::deque<Write> pending;
+    size_t outstanding = 0;
+    bool scheduled = false;
+
+    size_t highWaterMark = 0;
+    uint64_t droppedCount = 0;
+    uint64_t writtenCount = 0;
+    uint64_t failedCount = 0;
+};
+
+/** @brief The queue shared by the Add SEL Entry and Platform Event
+ *         handlers, which also puts its counters on D-Bus
+ */
+SELQueue& getSELQueue();
+
+} // namespace sel
+
+} // namespace ipmi
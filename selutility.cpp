@@ -22,6 +22,8 @@ namespace
 
 constexpr auto systemEventRecord = 0x02;
 constexpr auto generatorID = 0x2000;
+// The generator ID phosphor-sel-logger logs the BMC's own events with
+constexpr auto selLoggerGeneratorID = 0x0020;
 constexpr auto eventMsgRevision = 0x04;
 constexpr auto assertEvent = 0x00;
 constexpr auto deassertEvent = 0x80;
@@ -55,7 +57,7 @@ inline bool isRecordOEM(uint8_t recordType)
 }
 
 using additionalDataMap = std::map<std::string, std::string>;
-using entryDataMap = std::map<PropertyName, PropertyType>;
+using entryDataMap = EntryProperties;
 /** Parse the entry with format like key=val */
 std::pair<std::string, std::string> parseEntry(const std::string& entry)
 {
@@ -176,29 +178,11 @@ void constructSEL(uint8_t recordType, std::chrono::milliseconds timestamp,
 }
 
 GetSELEntryResponse
-    prepareSELEntry(const std::string& objPath,
+    prepareSELEntry(const entryDataMap& entryData,
                     ipmi::sensor::InvObjectIDMap::const_iterator iter)
 {
     GetSELEntryResponse record{};
 
-    sdbusplus::bus::bus bus{ipmid_get_sd_bus_connection()};
-    auto service = ipmi::getService(bus, logEntryIntf, objPath);
-
-    // Read all the log entry properties.
-    auto methodCall = bus.new_method_call(service.c_str(), objPath.c_str(),
-                                          propIntf, "GetAll");
-    methodCall.append(logEntryIntf);
-
-    auto reply = bus.call(methodCall);
-    if (reply.is_method_error())
-    {
-        log<level::ERR>("Error in reading logging property entries");
-        elog<InternalFailure>();
-    }
-
-    entryDataMap entryData;
-    reply.read(entryData);
-
     // Read Id from the log entry.
     static constexpr auto propId = "Id";
     auto iterId = entryData.find(propId);
@@ -303,14 +287,43 @@ GetSELEntryResponse
     return record;
 }
 
+/*
+ * Check if the log entry has any callout associations, if there is a
+ * callout association try to match the inventory path to the corresponding
+ * IPMI sensor. If there are no callout associations link the log entry to
+ * system event sensor.
+ */
+ipmi::sensor::InvObjectIDMap::const_iterator
+    findSensor(const AssociationList& assocs)
+{
+    for (const auto& item : assocs)
+    {
+        if (std::get<0>(item).compare(CALLOUT_FWD_ASSOCIATION) == 0)
+        {
+            auto iter = invSensors.find(std::get<2>(item));
+            if (iter == invSensors.end())
+            {
+                iter = invSensors.find(BOARD_SENSOR);
+                if (iter == invSensors.end())
+                {
+                    log<level::ERR>("Motherboard sensor not found");
+                    elog<InternalFailure>();
+                }
+            }
+
+            return iter;
+        }
+    }
+
+    return invSensors.find(SYSTEM_SENSOR);
+}
+
 } // namespace internal
 
 GetSELEntryResponse convertLogEntrytoSEL(const std::string& objPath)
 {
     sdbusplus::bus::bus bus{ipmid_get_sd_bus_connection()};
 
-    static constexpr auto assocIntf =
-        "xyz.openbmc_project.Association.Definitions";
     static constexpr auto assocProp = "Associations";
 
     auto service = ipmi::getService(bus, assocIntf, objPath);
@@ -328,42 +341,64 @@ GetSELEntryResponse convertLogEntrytoSEL(const std::string& objPath)
         elog<InternalFailure>();
     }
 
-    using AssociationList =
-        std::vector<std::tuple<std::string, std::string, std::string>>;
-
     std::variant<AssociationList> list;
     reply.read(list);
 
-    auto& assocs = std::get<AssociationList>(list);
+    auto iter = internal::findSensor(std::get<AssociationList>(list));
 
-    /*
-     * Check if the log entry has any callout associations, if there is a
-     * callout association try to match the inventory path to the corresponding
-     * IPMI sensor.
-     */
-    for (const auto& item : assocs)
+    service = ipmi::getService(bus, logEntryIntf, objPath);
+
+    // Read all the log entry properties.
+    methodCall = bus.new_method_call(service.c_str(), objPath.c_str(),
+                                     propIntf, "GetAll");
+    methodCall.append(logEntryIntf);
+
+    reply = bus.call(methodCall);
+    if (reply.is_method_error())
     {
-        if (std::get<0>(item).compare(CALLOUT_FWD_ASSOCIATION) == 0)
-        {
-            auto iter = invSensors.find(std::get<2>(item));
-            if (iter == invSensors.end())
-            {
-                iter = invSensors.find(BOARD_SENSOR);
-                if (iter == invSensors.end())
-                {
-                    log<level::ERR>("Motherboard sensor not found");
-                    elog<InternalFailure>();
-                }
-            }
+        log<level::ERR>("Error in reading logging property entries");
+        elog<InternalFailure>();
+    }
+
+    internal::entryDataMap entryData;
+    reply.read(entryData);
+
+    return internal::prepareSELEntry(entryData, iter);
+}
 
-            return internal::prepareSELEntry(objPath, iter);
+GetSELEntryResponse convertLogEntrytoSEL(const EntryInterfaces& interfaces)
+{
+    static const AssociationList noAssociations;
+    const AssociationList* assocs = &noAssociations;
+    auto assocIter = interfaces.find(assocIntf);
+    if (assocIter != interfaces.end())
+    {
+        auto listIter = assocIter->second.find("Associations");
+        if (listIter != assocIter->second.end() &&
+            std::holds_alternative<AssociationList>(listIter->second))
+        {
+            assocs = &std::get<AssociationList>(listIter->second);
         }
     }
 
-    // If there are no callout associations link the log entry to system event
-    // sensor
-    auto iter = invSensors.find(SYSTEM_SENSOR);
-    return internal::prepareSELEntry(objPath, iter);
+    auto iter = internal::findSensor(*assocs);
+
+    auto entryIter = interfaces.find(logEntryIntf);
+    if (entryIter == interfaces.end())
+    {
+        log<level::ERR>("Error in reading logging property entries");
+        elog<InternalFailure>();
+    }
+
+    return internal::prepareSELEntry(entryIter->second, iter);
+}
+
+bool isBMCEvent(const GetSELEntryResponse& record)
+{
+    const SELEventRecord& event = record.event.eventRecord;
+    return event.recordType == systemEventRecord &&
+           (event.generatorID == generatorID ||
+            event.generatorID == selLoggerGeneratorID);
 }
 
 std::chrono::seconds getEntryTimeStamp(const std::string& objPath)
@@ -395,6 +430,28 @@ std::chrono::seconds getEntryTimeStamp(const std::string& objPath)
     return std::chrono::duration_cast<std::chrono::seconds>(chronoTimeStamp);
 }
 
+std::chrono::seconds getEntryTimeStamp(const EntryInterfaces& interfaces)
+{
+    auto entryIter = interfaces.find(logEntryIntf);
+    if (entryIter == interfaces.end())
+    {
+        log<level::ERR>("Error in reading Timestamp from Entry interface");
+        elog<InternalFailure>();
+    }
+    auto iterTimeStamp = entryIter->second.find("Timestamp");
+    if (iterTimeStamp == entryIter->second.end() ||
+        !std::holds_alternative<Timestamp>(iterTimeStamp->second))
+    {
+        log<level::ERR>("Error in reading Timestamp from Entry interface");
+        elog<InternalFailure>();
+    }
+
+    std::chrono::milliseconds chronoTimeStamp(
+        std::get<Timestamp>(iterTimeStamp->second));
+
+    return std::chrono::duration_cast<std::chrono::seconds>(chronoTimeStamp);
+}
+
 void readLoggingObjectPaths(ObjectPaths& paths)
 {
     sdbusplus::bus::bus bus{ipmid_get_sd_bus_connection()};
@@ -416,19 +473,45 @@ void readLoggingObjectPaths(ObjectPaths& paths)
     {
         reply.read(paths);
 
-        std::sort(paths.begin(), paths.end(),
-                  [](const std::string& a, const std::string& b) {
-                      namespace fs = std::filesystem;
-                      fs::path pathA(a);
-                      fs::path pathB(b);
-                      auto idA = std::stoul(pathA.filename().string());
-                      auto idB = std::stoul(pathB.filename().string());
-
-                      return idA < idB;
+        // Parse each entry ID once rather than on every comparison
+        std::vector<std::pair<unsigned long, std::string>> sorted;
+        sorted.reserve(paths.size());
+        for (std::string& path : paths)
+        {
+            namespace fs = std::filesystem;
+            auto id = std::stoul(fs::path(path).filename().string());
+            sorted.emplace_back(id, std::move(path));
+        }
+        std::sort(sorted.begin(), sorted.end(),
+                  [](const auto& a, const auto& b) {
+                      return a.first < b.first;
                   });
+        for (size_t i = 0; i < sorted.size(); i++)
+        {
+            paths[i] = std::move(sorted[i].second);
+        }
     }
 }
 
+void readLoggingObjects(LoggingObjects& objects)
+{
+    sdbusplus::bus::bus bus{ipmid_get_sd_bus_connection()};
+
+    auto service = ipmi::getService(bus, objMgrIntf, logObjPath);
+
+    auto methodCall = bus.new_method_call(service.c_str(), logObjPath,
+                                          objMgrIntf, "GetManagedObjects");
+
+    auto reply = bus.call(methodCall);
+    if (reply.is_method_error())
+    {
+        log<level::ERR>("Error in reading logging objects");
+        elog<InternalFailure>();
+    }
+
+    reply.read(objects);
+}
+
 } // namespace sel
 
 } // namespace ipmi
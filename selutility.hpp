@@ -18,6 +18,11 @@ static constexpr auto mapperIntf = "xyz.openbmc_project.ObjectMapper";
 static constexpr auto logBasePath = "/xyz/openbmc_project/logging/entry";
 static constexpr auto logEntryIntf = "xyz.openbmc_project.Logging.Entry";
 static constexpr auto logDeleteIntf = "xyz.openbmc_project.Object.Delete";
+static constexpr auto logObjPath = "/xyz/openbmc_project/logging";
+static constexpr auto objMgrIntf = "org.freedesktop.DBus.ObjectManager";
+static constexpr auto assocIntf = "xyz.openbmc_project.Association.Definitions";
+static constexpr auto logDeleteAllIntf =
+    "xyz.openbmc_project.Collection.DeleteAll";
 
 static constexpr auto propIntf = "org.freedesktop.DBus.Properties";
 
@@ -30,6 +35,16 @@ using Message = std::string;
 using AdditionalData = std::vector<std::string>;
 using PropertyType =
     std::variant<Resolved, Id, Timestamp, Message, AdditionalData>;
+using AssociationList =
+    std::vector<std::tuple<std::string, std::string, std::string>>;
+
+// Properties of the logging entry objects, as read by GetManagedObjects
+using EntryPropertyType = std::variant<Resolved, Id, Timestamp, Message,
+                                       AdditionalData, AssociationList>;
+using EntryProperties = std::map<PropertyName, EntryPropertyType>;
+using EntryInterfaces = std::map<std::string, EntryProperties>;
+using LoggingObjects =
+    std::map<sdbusplus::message::object_path, EntryInterfaces>;
 
 static constexpr auto selVersion = 0x51;
 static constexpr auto invalidTimeStamp = 0xFFFFFFFF;
@@ -133,6 +148,7 @@ static_assert(sizeof(GetSELEntryResponse) ==
 
 static constexpr auto initiateErase = 0xAA;
 static constexpr auto getEraseStatus = 0x00;
+static constexpr auto eraseInProgress = 0x00;
 static constexpr auto eraseComplete = 0x01;
 
 /** @brief Convert logging entry to SEL
@@ -143,6 +159,26 @@ static constexpr auto eraseComplete = 0x01;
  */
 GetSELEntryResponse convertLogEntrytoSEL(const std::string& objPath);
 
+/** @brief Convert logging entry to SEL, from its properties
+ *
+ *  @param[in] interfaces - interfaces and properties of the logging entry,
+ *                          as returned by GetManagedObjects.
+ *
+ *  @return On success return the response of Get SEL entry command.
+ */
+GetSELEntryResponse convertLogEntrytoSEL(const EntryInterfaces& interfaces);
+
+/** @brief Whether a SEL record is a system event the BMC generated
+ *
+ *  Records the host added, through Add SEL Entry or IpmiSelAdd, carry the
+ *  host's generator ID, and OEM records are no events at all.
+ *
+ *  @param[in] record - a record made by convertLogEntrytoSEL.
+ *
+ *  @return true if the record is a BMC system event.
+ */
+bool isBMCEvent(const GetSELEntryResponse& record);
+
 /** @brief Get the timestamp of the log entry
  *
  *  @param[in] objPath - DBUS object path of the logging entry.
@@ -152,6 +188,15 @@ GetSELEntryResponse convertLogEntrytoSEL(const std::string& objPath);
  */
 std::chrono::seconds getEntryTimeStamp(const std::string& objPath);
 
+/** @brief Get the timestamp of the log entry, from its properties
+ *
+ *  @param[in] interfaces - interfaces and properties of the logging entry.
+ *
+ *  @return On success return the timestamp of the log entry as number of
+ *          seconds from epoch.
+ */
+std::chrono::seconds getEntryTimeStamp(const EntryInterfaces& interfaces);
+
 /** @brief Read the logging entry object paths
  *
  *  This API would read the logging dbus logging entry object paths and sorting
@@ -160,13 +205,20 @@ std::chrono::seconds getEntryTimeStamp(const std::string& objPath);
  *
  *  @param[in,out] paths - sorted list of logging entry object paths.
  *
- *  @note This function is invoked when the Get SEL Info command or the Delete
- *        SEL entry command is invoked. The Get SEL Entry command is preceded
- *        typically by Get SEL Info command, so readLoggingObjectPaths is not
- *        invoked before each Get SEL entry command.
+ *  @note The SEL commands only invoke this function to fill their record
+ *        ID cache, signals keep the cache current after that.
  */
 void readLoggingObjectPaths(ObjectPaths& paths);
 
+/** @brief Read all the logging objects and their properties
+ *
+ *  One GetManagedObjects call to the logging service, instead of one
+ *  property read per entry.
+ *
+ *  @param[out] objects - logging objects with their interfaces.
+ */
+void readLoggingObjects(LoggingObjects& objects);
+
 namespace internal
 {
 
@@ -3,11 +3,17 @@
 #include "sensorhandler.hpp"
 
 #include <bitset>
+#include <boost/asio/steady_timer.hpp>
+#include <chrono>
 #include <filesystem>
 #include <ipmid/types.hpp>
 #include <ipmid/utils.hpp>
+#include <list>
+#include <map>
+#include <memory>
 #include <optional>
 #include <sdbusplus/message/types.hpp>
+#include <unordered_map>
 #include <xyz/openbmc_project/Common/error.hpp>
 
 namespace ipmi
@@ -23,6 +29,109 @@ static constexpr auto MAPPER_BUSNAME = "xyz.openbmc_project.ObjectMapper";
 static constexpr auto MAPPER_PATH = "/xyz/openbmc_project/object_mapper";
 static constexpr auto MAPPER_INTERFACE = "xyz.openbmc_project.ObjectMapper";
 
+namespace
+{
+
+// Services of the sensor objects, by object path and interface
+std::map<std::pair<Path, Interface>, Service> sensorServices;
+// A NameOwnerChanged match for each service name in use, so that other
+// clients coming and going do not wake ipmid up
+std::map<Service, std::unique_ptr<sdbusplus::bus::match_t>> ownerMatches;
+
+void nameOwnerChanged(sdbusplus::message::message& msg)
+{
+    std::string name;
+    std::string oldOwner;
+    std::string newOwner;
+    try
+    {
+        msg.read(name, oldOwner, newOwner);
+    }
+    catch (const sdbusplus::exception_t& e)
+    {
+        log<level::ERR>("Failed to read NameOwnerChanged",
+                        entry("ERROR=%s", e.what()));
+        return;
+    }
+    if (oldOwner.empty())
+    {
+        return;
+    }
+
+    // The name was released or taken over, so look its objects up again
+    evictSensorService(name);
+}
+
+} // namespace
+
+Service getSensorService(sdbusplus::bus::bus& bus, const std::string& interface,
+                         const std::string& path)
+{
+    auto key = std::make_pair(path, interface);
+    auto cached = sensorServices.find(key);
+    if (cached != sensorServices.end())
+    {
+        return cached->second;
+    }
+    auto service = ipmi::getService(bus, interface, path);
+    if (ownerMatches.find(service) == ownerMatches.end())
+    {
+        ownerMatches.emplace(
+            service,
+            std::make_unique<sdbusplus::bus::match_t>(
+                bus, sdbusplus::bus::match::rules::nameOwnerChanged(service),
+                nameOwnerChanged));
+    }
+    sensorServices.emplace(std::move(key), service);
+    return service;
+}
+
+void evictSensorService(const Service& service)
+{
+    for (auto it = sensorServices.begin(); it != sensorServices.end();)
+    {
+        if (it->second == service)
+        {
+            it = sensorServices.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+Value getSensorProperty(sdbusplus::bus::bus& bus, const Service& service,
+                        const std::string& path, const std::string& interface,
+                        const std::string& property)
+{
+    try
+    {
+        return ipmi::getDbusProperty(bus, service, path, interface, property);
+    }
+    catch (const std::exception& e)
+    {
+        evictSensorService(service);
+        throw;
+    }
+}
+
+PropertyMap getAllSensorProperties(sdbusplus::bus::bus& bus,
+                                   const Service& service,
+                                   const std::string& path,
+                                   const std::string& interface)
+{
+    try
+    {
+        return ipmi::getAllDbusProperties(bus, service, path, interface);
+    }
+    catch (const std::exception& e)
+    {
+        evictSensorService(service);
+        throw;
+    }
+}
+
 /** @brief get the D-Bus service and service path
  *  @param[in] bus - The Dbus bus object
  *  @param[in] interface - interface to the service
@@ -87,26 +196,119 @@ AssertionSet getAssertionSet(const SetSensorReadingReq& cmdData)
     return std::make_pair(assertionStates, deassertionStates);
 }
 
-ipmi_ret_t updateToDbus(IpmiUpdateData& msg)
+namespace
 {
-    sdbusplus::bus::bus bus{ipmid_get_sd_bus_connection()};
-    try
+
+// How long updates wait to be merged, and how many may wait
+constexpr auto updateWindow = std::chrono::milliseconds(20);
+constexpr size_t maxPendingUpdates = 64;
+
+struct PendingUpdate
+{
+    std::string key;
+    IpmiUpdateData msg;
+};
+
+// Oldest first
+std::list<PendingUpdate> updates;
+std::unordered_map<std::string, std::list<PendingUpdate>::iterator>
+    updatesByKey;
+UpdateStatistics updateStats{};
+std::unique_ptr<boost::asio::steady_timer> updateTimer;
+bool flushScheduled = false;
+
+void flushUpdates()
+{
+    flushScheduled = false;
+    auto bus = getSdBus();
+    for (auto& update : updates)
     {
-        auto serviceResponseMsg = bus.call(msg);
-        if (serviceResponseMsg.is_method_error())
-        {
-            log<level::ERR>("Error in D-Bus call");
-            return IPMI_CC_UNSPECIFIED_ERROR;
-        }
+        updateStats.sent++;
+        // The service the message was made for, by getSensorService
+        const char* destination =
+            sd_bus_message_get_destination(update.msg.get());
+        Service service = destination != nullptr ? destination : "";
+        bus->async_send(
+            update.msg, [service](boost::system::error_code ec,
+                                  sdbusplus::message::message& reply) {
+                if (ec)
+                {
+                    log<level::ERR>("Error in D-Bus sensor update",
+                                    entry("ERROR=%s", ec.message().c_str()));
+                }
+                else if (reply.is_method_error())
+                {
+                    // The call went out, the service answered with an error
+                    const sd_bus_error* error = reply.get_error();
+                    const char* name =
+                        error != nullptr && error->name != nullptr
+                            ? error->name
+                            : "unknown";
+                    log<level::ERR>("Error in D-Bus sensor update",
+                                    entry("ERROR=%s", name));
+                }
+                else
+                {
+                    return;
+                }
+                updateStats.failed++;
+                // Look the objects up again, the service may have gone
+                evictSensorService(service);
+            });
+    }
+    updates.clear();
+    updatesByKey.clear();
+}
+
+} // namespace
+
+ipmi_ret_t updateToDbus(IpmiUpdateData& msg, const std::string& key)
+{
+    auto queued = updatesByKey.find(key);
+    if (queued != updatesByKey.end())
+    {
+        updates.erase(queued->second);
+        updatesByKey.erase(queued);
+        updateStats.coalesced++;
     }
-    catch (InternalFailure& e)
+    updates.push_back({key, std::move(msg)});
+    updatesByKey.emplace(key, std::prev(updates.end()));
+    updateStats.queued++;
+
+    if (!updateTimer)
     {
-        commit<InternalFailure>();
-        return IPMI_CC_UNSPECIFIED_ERROR;
+        updateTimer = std::make_unique<boost::asio::steady_timer>(
+            *getIoContext());
+    }
+    if (updates.size() >= maxPendingUpdates)
+    {
+        updateTimer->cancel();
+        flushUpdates();
+    }
+    else if (!flushScheduled)
+    {
+        flushScheduled = true;
+        updateTimer->expires_after(updateWindow);
+        updateTimer->async_wait([](const boost::system::error_code& ec) {
+            if (!ec)
+            {
+                flushUpdates();
+            }
+        });
     }
     return IPMI_CC_OK;
 }
 
+const UpdateStatistics& updateStatistics()
+{
+    return updateStats;
+}
+
+size_t pendingUpdates()
+{
+    return updates.size();
+}
+
 namespace get
 {
 
@@ -133,20 +335,34 @@ GetSensorResponse mapDbusToAssertion(const Info& sensorInfo,
 
     enableScanning(&response);
 
-    auto service = ipmi::getService(bus, interface, path);
+    auto service = getSensorService(bus, interface, path);
 
     const auto& interfaceList = sensorInfo.propertyInterfaces;
 
     for (const auto& interface : interfaceList)
     {
+        if (interface.second.empty())
+        {
+            continue;
+        }
+        // One call for all the properties of the interface
+        auto properties =
+            getAllSensorProperties(bus, service, path, interface.first);
+
         for (const auto& property : interface.second)
         {
-            auto propValue = ipmi::getDbusProperty(
-                bus, service, path, interface.first, property.first);
+            auto propValue = properties.find(property.first);
+            if (propValue == properties.end())
+            {
+                log<level::ERR>("Sensor property not found",
+                                entry("PATH=%s", path.c_str()),
+                                entry("PROPERTY=%s", property.first.c_str()));
+                elog<InternalFailure>();
+            }
 
             for (const auto& value : std::get<OffsetValueMap>(property.second))
             {
-                if (propValue == value.second.assert)
+                if (propValue->second == value.second.assert)
                 {
                     setOffset(value.first, &response);
                     break;
@@ -171,22 +387,36 @@ GetSensorResponse eventdata2(const Info& sensorInfo)
 
     enableScanning(&response);
 
-    auto service = ipmi::getService(bus, sensorInfo.sensorInterface,
+    auto service = getSensorService(bus, sensorInfo.sensorInterface,
                                     sensorInfo.sensorPath);
 
     const auto& interfaceList = sensorInfo.propertyInterfaces;
 
     for (const auto& interface : interfaceList)
     {
+        if (interface.second.empty())
+        {
+            continue;
+        }
+        // One call for all the properties of the interface
+        auto properties = getAllSensorProperties(
+            bus, service, sensorInfo.sensorPath, interface.first);
+
         for (const auto& property : interface.second)
         {
-            auto propValue =
-                ipmi::getDbusProperty(bus, service, sensorInfo.sensorPath,
-                                      interface.first, property.first);
+            auto propValue = properties.find(property.first);
+            if (propValue == properties.end())
+            {
+                log<level::ERR>(
+                    "Sensor property not found",
+                    entry("PATH=%s", sensorInfo.sensorPath.c_str()),
+                    entry("PROPERTY=%s", property.first.c_str()));
+                elog<InternalFailure>();
+            }
 
             for (const auto& value : std::get<OffsetValueMap>(property.second))
             {
-                if (propValue == value.second.assert)
+                if (propValue->second == value.second.assert)
                 {
                     setReading(value.first, &response);
                     break;
@@ -211,7 +441,7 @@ IpmiUpdateData makeDbusMsg(const std::string& updateInterface,
     sdbusplus::bus::bus bus{ipmid_get_sd_bus_connection()};
     using namespace std::string_literals;
 
-    auto dbusService = getService(bus, sensorInterface, sensorPath);
+    auto dbusService = getSensorService(bus, sensorInterface, sensorPath);
 
     return bus.new_method_call(dbusService.c_str(), sensorPath.c_str(),
                                updateInterface.c_str(), command.c_str());
@@ -237,7 +467,8 @@ ipmi_ret_t eventdata(const SetSensorReadingReq& cmdData, const Info& sensorInfo,
         }
         msg.append(iter->second.assert);
     }
-    return updateToDbus(msg);
+    return updateToDbus(msg, updateKey(sensorInfo.sensorPath, interface->first,
+                                       interface->second.begin()->first));
 }
 
 ipmi_ret_t assertion(const SetSensorReadingReq& cmdData, const Info& sensorInfo)
@@ -280,11 +511,8 @@ ipmi_ret_t assertion(const SetSensorReadingReq& cmdData, const Info& sensorInfo)
             msg.append(property.first);
             msg.append(*tmp);
 
-            auto rc = updateToDbus(msg);
-            if (rc)
-            {
-                return rc;
-            }
+            updateToDbus(msg, updateKey(sensorInfo.sensorPath,
+                                        interface->first, property.first));
         }
     }
 
@@ -305,7 +533,7 @@ IpmiUpdateData makeDbusMsg(const std::string& updateInterface,
     using namespace std::string_literals;
 
     static const auto dbusPath = "/xyz/openbmc_project/inventory"s;
-    std::string dbusService = ipmi::getService(bus, updateInterface, dbusPath);
+    std::string dbusService = getSensorService(bus, updateInterface, dbusPath);
 
     return bus.new_method_call(dbusService.c_str(), dbusPath.c_str(),
                                updateInterface.c_str(), command.c_str());
@@ -381,9 +609,22 @@ ipmi_ret_t assertion(const SetSensorReadingReq& cmdData, const Info& sensorInfo)
         }
     }
 
+    // Notify only changes the properties it carries, so it replaces a
+    // queued Notify for the same ones
+    auto key = updateKey(sensorInfo.sensorPath, sensorInfo.sensorInterface,
+                         "Notify");
+    for (const auto& [name, properties] : interfaces)
+    {
+        key += ' ' + name;
+        for (const auto& property : properties)
+        {
+            key += ' ' + property.first;
+        }
+    }
+
     objects.emplace(sensorInfo.sensorPath, std::move(interfaces));
     msg.append(std::move(objects));
-    return updateToDbus(msg);
+    return updateToDbus(msg, key);
 }
 
 } // namespace notify
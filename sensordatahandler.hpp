@@ -42,17 +42,105 @@ ServicePath getServiceAndPath(sdbusplus::bus::bus& bus,
                               const std::string& interface,
                               const std::string& path = std::string());
 
+/** @brief get the D-Bus service of a sensor object
+ *  @details The service is looked up once and kept until its owner
+ *           changes on the bus, or a call to it fails.
+ *  @param[in] bus - The Dbus bus object
+ *  @param[in] interface - interface to the service
+ *  @param[in] path - sensor object path
+ *  @return service
+ */
+Service getSensorService(sdbusplus::bus::bus& bus, const std::string& interface,
+                         const std::string& path);
+
+/** @brief Drop the cached objects of a service, so that they are looked up
+ *         again on their next use
+ *  @param[in] service - service returned by getSensorService
+ */
+void evictSensorService(const Service& service);
+
+/** @brief Read a property through a service from getSensorService,
+ *         dropping the cached service if the read fails
+ *  @param[in] bus - The Dbus bus object
+ *  @param[in] service - service returned by getSensorService
+ *  @param[in] path - sensor object path
+ *  @param[in] interface - interface of the property
+ *  @param[in] property - property name
+ *  @return property value
+ */
+Value getSensorProperty(sdbusplus::bus::bus& bus, const Service& service,
+                        const std::string& path, const std::string& interface,
+                        const std::string& property);
+
+/** @brief Read all properties of an interface, as getSensorProperty
+ *  @param[in] bus - The Dbus bus object
+ *  @param[in] service - service returned by getSensorService
+ *  @param[in] path - sensor object path
+ *  @param[in] interface - interface to read
+ *  @return properties of the interface
+ */
+PropertyMap getAllSensorProperties(sdbusplus::bus::bus& bus,
+                                   const Service& service,
+                                   const std::string& path,
+                                   const std::string& interface);
+
 /** @brief Make assertion set from input data
  *  @param[in] cmdData - Input sensor data
  *  @return pair of assertion and deassertion set
  */
 AssertionSet getAssertionSet(const SetSensorReadingReq& cmdData);
 
+// Counters of the sensor updates sent to D-Bus
+struct UpdateStatistics
+{
+    uint64_t queued;
+    // Replaced by a newer update before being sent
+    uint64_t coalesced;
+    uint64_t sent;
+    uint64_t failed;
+};
+
+/** @brief Key of an update to a property of a sensor object
+ *  @param[in] path - object path
+ *  @param[in] interface - interface of the property
+ *  @param[in] property - property name
+ *  @return key for updateToDbus
+ */
+inline std::string updateKey(const std::string& path,
+                             const std::string& interface,
+                             const std::string& property)
+{
+    // Spaces are not valid in any of the names
+    return path + ' ' + interface + ' ' + property;
+}
+
 /** @brief send the message to DBus
+ *  @details The host sends bursts of Set Sensor Reading commands during
+ *           POST, so the message is queued and answered at once. After a
+ *           short window the queued messages are sent as asynchronous
+ *           calls, in the order they were last queued. A message whose key
+ *           is queued already replaces that one and moves to the end, so
+ *           only the newest value of an object property is sent and it
+ *           still follows the updates queued before it. The bus delivers
+ *           the calls to a service in the order they were sent. A failed
+ *           call is logged and counted, the host is not told.
+ *
+ *           Reads go to the sensor objects, so a Get Sensor Reading
+ *           within the 20 ms window after a Set Sensor Reading still
+ *           returns the value from before the set.
  *  @param[in] msg - message to send
- *  @return failure status in IPMI error code
+ *  @param[in] key - what the message updates, see updateKey
+ *  @return IPMI_CC_OK, the message is always queued
  */
-ipmi_ret_t updateToDbus(IpmiUpdateData& msg);
+ipmi_ret_t updateToDbus(IpmiUpdateData& msg, const std::string& key);
+
+/** @brief Statistics of the updates sent by updateToDbus
+ *  @return counters since start up
+ */
+const UpdateStatistics& updateStatistics();
+
+/** @brief Number of updates queued and not sent yet */
+size_t pendingUpdates();
 
 namespace get
 {
@@ -162,10 +250,10 @@ GetSensorResponse readingAssertion(const Info& sensorInfo)
 
     enableScanning(&response);
 
-    auto service = ipmi::getService(bus, sensorInfo.sensorInterface,
+    auto service = getSensorService(bus, sensorInfo.sensorInterface,
                                     sensorInfo.sensorPath);
 
-    auto propValue = ipmi::getDbusProperty(
+    auto propValue = getSensorProperty(
         bus, service, sensorInfo.sensorPath,
         sensorInfo.propertyInterfaces.begin()->first,
         sensorInfo.propertyInterfaces.begin()->second.begin()->first);
@@ -192,7 +280,7 @@ GetSensorResponse readingData(const Info& sensorInfo)
 
     enableScanning(&response);
 
-    auto service = ipmi::getService(bus, sensorInfo.sensorInterface,
+    auto service = getSensorService(bus, sensorInfo.sensorInterface,
                                     sensorInfo.sensorPath);
 
 #ifdef UPDATE_FUNCTIONAL_ON_FAIL
@@ -221,7 +309,7 @@ GetSensorResponse readingData(const Info& sensorInfo)
     }
 #endif
 
-    auto propValue = ipmi::getDbusProperty(
+    auto propValue = getSensorProperty(
         bus, service, sensorInfo.sensorPath,
         sensorInfo.propertyInterfaces.begin()->first,
         sensorInfo.propertyInterfaces.begin()->second.begin()->first);
@@ -311,7 +399,8 @@ ipmi_ret_t readingAssertion(const SetSensorReadingReq& cmdData,
                                                cmdData.assertOffset0_7);
         msg.append(value);
     }
-    return updateToDbus(msg);
+    return updateToDbus(msg, updateKey(sensorInfo.sensorPath, interface->first,
+                                       interface->second.begin()->first));
 }
 
 /** @brief Update d-bus based on a discrete reading
@@ -341,7 +430,8 @@ ipmi_ret_t readingData(const SetSensorReadingReq& cmdData,
         std::variant<T> value = raw_value;
         msg.append(value);
     }
-    return updateToDbus(msg);
+    return updateToDbus(msg, updateKey(sensorInfo.sensorPath, interface->first,
+                                       interface->second.begin()->first));
 }
 
 /** @brief Update d-bus based on eventdata type sensor data
@@ -4,11 +4,15 @@
 
 #include "entity_map_json.hpp"
 #include "fruread.hpp"
+#include "host-event-buffer.hpp"
+#include "selqueue.hpp"
+#include "sensordatahandler.hpp"
 
 #include <mapper.h>
 #include <systemd/sd-bus.h>
 
 #include <bitset>
+#include <boost/container/flat_map.hpp>
 #include <cmath>
 #include <cstring>
 #include <ipmid/api.hpp>
@@ -33,6 +37,21 @@ namespace ipmi
 namespace sensor
 {
 extern const IdInfoMap sensors;
+extern const IdPositionMap sensorPositions;
+
+/** @brief Find a sensor by number, indexing the generated positions
+ *  @param[in] sensorNum - sensor number
+ *  @return the sensor, or sensors.end() if there is none with the number
+ */
+static IdInfoMap::const_iterator findSensor(uint8_t sensorNum)
+{
+    uint16_t position = sensorPositions[sensorNum];
+    if (position == noIdPosition)
+    {
+        return sensors.end();
+    }
+    return sensors.nth(position);
+}
 } // namespace sensor
 } // namespace ipmi
 
@@ -91,7 +110,7 @@ int find_openbmc_path(uint8_t num, dbus_interface_t* interface)
 {
     int rc;
 
-    const auto& sensor_it = ipmi::sensor::sensors.find(num);
+    const auto sensor_it = ipmi::sensor::findSensor(num);
     if (sensor_it == ipmi::sensor::sensors.end())
     {
         // The sensor map does not contain the sensor requested
@@ -364,7 +383,7 @@ ipmi::RspType<> ipmiSetSensorReading(uint8_t sensorNumber, uint8_t operation,
     cmdData.eventData3 = eventData3;
 
     // Check if the Sensor Number is present
-    const auto iter = ipmi::sensor::sensors.find(sensorNumber);
+    const auto iter = ipmi::sensor::findSensor(sensorNumber);
     if (iter == ipmi::sensor::sensors.end())
     {
         updateSensorRecordFromSSRAESC(&sensorNumber);
@@ -426,7 +445,7 @@ ipmi::RspType<uint8_t, // sensor reading
         return ipmi::responseInvalidFieldRequest();
     }
 
-    const auto iter = ipmi::sensor::sensors.find(sensorNum);
+    const auto iter = ipmi::sensor::findSensor(sensorNum);
     if (iter == ipmi::sensor::sensors.end())
     {
         return ipmi::responseSensorInvalid();
@@ -481,7 +500,7 @@ get_sdr::GetSensorThresholdsResponse
     constexpr auto criticalThreshIntf =
         "xyz.openbmc_project.Sensor.Threshold.Critical";
 
-    const auto iter = ipmi::sensor::sensors.find(sensorNum);
+    const auto iter = ipmi::sensor::findSensor(sensorNum);
     const auto info = iter->second;
 
     std::string service;
@@ -578,7 +597,7 @@ ipmi::RspType<uint8_t, // validMask
 {
     constexpr auto valueInterface = "xyz.openbmc_project.Sensor.Value";
 
-    const auto iter = ipmi::sensor::sensors.find(sensorNum);
+    const auto iter = ipmi::sensor::findSensor(sensorNum);
     if (iter == ipmi::sensor::sensors.end())
     {
         return ipmi::responseSensorInvalid();
@@ -741,27 +760,46 @@ ipmi_ret_t populate_record_from_dbus(get_sdr::SensorDataFullRecordBody* body,
     return IPMI_CC_OK;
 };
 
-ipmi_ret_t ipmi_fru_get_sdr(ipmi_request_t request, ipmi_response_t response,
-                            ipmi_data_len_t data_len)
+static get_sdr::SensorDataFullRecord
+    makeFullRecord(ipmi::sensor::Id sensor_id, const ipmi::sensor::Info& info)
 {
-    auto req = reinterpret_cast<get_sdr::GetSdrReq*>(request);
-    auto resp = reinterpret_cast<get_sdr::GetSdrResp*>(response);
-    get_sdr::SensorDataFruRecord record{};
-    auto dataLength = 0;
+    get_sdr::SensorDataFullRecord record{};
 
-    auto fru = frus.begin();
-    uint8_t fruID{};
-    auto recordID = get_sdr::request::get_record_id(req);
+    /* Header */
+    get_sdr::header::set_record_id(sensor_id, &(record.header));
+    record.header.sdr_version = 0x51; // Based on IPMI Spec v2.0 rev 1.1
+    record.header.record_type = get_sdr::SENSOR_DATA_FULL_RECORD;
+    record.header.record_length = sizeof(record.key) + sizeof(record.body);
 
-    fruID = recordID - FRU_RECORD_ID_START;
-    fru = frus.find(fruID);
-    if (fru == frus.end())
+    /* Key */
+    get_sdr::key::set_owner_id_bmc(&(record.key));
+    record.key.sensor_number = sensor_id;
+
+    /* Body */
+    record.body.entity_id = info.entityType;
+    record.body.sensor_type = info.sensorType;
+    record.body.event_reading_type = info.sensorReadingType;
+    record.body.entity_instance = info.instance;
+    if (ipmi::sensor::Mutability::Write ==
+        (info.mutability & ipmi::sensor::Mutability::Write))
     {
-        return IPMI_CC_SENSOR_INVALID;
+        get_sdr::body::init_settable_state(true, &(record.body));
     }
 
+    // Set the type-specific details given the DBus interface
+    populate_record_from_dbus(&(record.body), &info, nullptr);
+
+    return record;
+}
+
+static get_sdr::SensorDataFruRecord makeFruRecord(uint8_t fruID,
+                                                  const FruInstanceVec& fru)
+{
+    get_sdr::SensorDataFruRecord record{};
+
     /* Header */
-    get_sdr::header::set_record_id(recordID, &(record.header));
+    get_sdr::header::set_record_id(FRU_RECORD_ID_START + fruID,
+                                   &(record.header));
     record.header.sdr_version = SDR_VERSION; // Based on IPMI Spec v2.0 rev 1.1
     record.header.record_type = get_sdr::SENSOR_DATA_FRU_RECORD;
     record.header.record_length = sizeof(record.key) + sizeof(record.body);
@@ -772,15 +810,14 @@ ipmi_ret_t ipmi_fru_get_sdr(ipmi_request_t request, ipmi_response_t response,
     record.key.deviceAddress = BMCSlaveAddress;
 
     /* Body */
-    record.body.entityID = fru->second[0].entityID;
-    record.body.entityInstance = fru->second[0].entityInstance;
+    record.body.entityID = fru[0].entityID;
+    record.body.entityInstance = fru[0].entityInstance;
     record.body.deviceType = fruInventoryDevice;
     record.body.deviceTypeModifier = IPMIFruInventory;
 
     /* Device ID string */
-    auto deviceID =
-        fru->second[0].path.substr(fru->second[0].path.find_last_of('/') + 1,
-                                   fru->second[0].path.length());
+    auto deviceID = fru[0].path.substr(fru[0].path.find_last_of('/') + 1,
+                                       fru[0].path.length());
 
     if (deviceID.length() > get_sdr::FRU_RECORD_DEVICE_ID_MAX_LENGTH)
     {
@@ -795,200 +832,137 @@ ipmi_ret_t ipmi_fru_get_sdr(ipmi_request_t request, ipmi_response_t response,
     strncpy(record.body.deviceID, deviceID.c_str(),
             get_sdr::body::get_device_id_strlen(&(record.body)));
 
-    if (++fru == frus.end())
-    {
-        // we have reached till end of fru, so assign the next record id to
-        // 512(Max fru ID = 511) + Entity Record ID(may start with 0).
-        const auto& entityRecords =
-            ipmi::sensor::EntityInfoMapContainer::getContainer()
-                ->getIpmiEntityRecords();
-        auto next_record_id =
-            (entityRecords.size())
-                ? entityRecords.begin()->first + ENTITY_RECORD_ID_START
-                : END_OF_RECORD;
-        get_sdr::response::set_next_record_id(next_record_id, resp);
-    }
-    else
-    {
-        get_sdr::response::set_next_record_id(
-            (FRU_RECORD_ID_START + fru->first), resp);
-    }
-
-    // Check for invalid offset size
-    if (req->offset > sizeof(record))
-    {
-        return IPMI_CC_PARM_OUT_OF_RANGE;
-    }
-
-    dataLength = std::min(static_cast<size_t>(req->bytes_to_read),
-                          sizeof(record) - req->offset);
-
-    std::memcpy(resp->record_data,
-                reinterpret_cast<uint8_t*>(&record) + req->offset, dataLength);
-
-    *data_len = dataLength;
-    *data_len += 2; // additional 2 bytes for next record ID
-
-    return IPMI_CC_OK;
+    return record;
 }
 
-ipmi_ret_t ipmi_entity_get_sdr(ipmi_request_t request, ipmi_response_t response,
-                               ipmi_data_len_t data_len)
+static get_sdr::SensorDataEntityRecord
+    makeEntityRecord(uint8_t entityRecordID,
+                     const ipmi::sensor::EntityInfo& entity)
 {
-    auto req = reinterpret_cast<get_sdr::GetSdrReq*>(request);
-    auto resp = reinterpret_cast<get_sdr::GetSdrResp*>(response);
     get_sdr::SensorDataEntityRecord record{};
-    auto dataLength = 0;
-
-    const auto& entityRecords =
-        ipmi::sensor::EntityInfoMapContainer::getContainer()
-            ->getIpmiEntityRecords();
-    auto entity = entityRecords.begin();
-    uint8_t entityRecordID;
-    auto recordID = get_sdr::request::get_record_id(req);
-
-    entityRecordID = recordID - ENTITY_RECORD_ID_START;
-    entity = entityRecords.find(entityRecordID);
-    if (entity == entityRecords.end())
-    {
-        return IPMI_CC_SENSOR_INVALID;
-    }
 
     /* Header */
-    get_sdr::header::set_record_id(recordID, &(record.header));
+    get_sdr::header::set_record_id(ENTITY_RECORD_ID_START + entityRecordID,
+                                   &(record.header));
     record.header.sdr_version = SDR_VERSION; // Based on IPMI Spec v2.0 rev 1.1
     record.header.record_type = get_sdr::SENSOR_DATA_ENTITY_RECORD;
     record.header.record_length = sizeof(record.key) + sizeof(record.body);
 
     /* Key */
-    record.key.containerEntityId = entity->second.containerEntityId;
-    record.key.containerEntityInstance = entity->second.containerEntityInstance;
-    get_sdr::key::set_flags(entity->second.isList, entity->second.isLinked,
-                            &(record.key));
-    record.key.entityId1 = entity->second.containedEntities[0].first;
-    record.key.entityInstance1 = entity->second.containedEntities[0].second;
+    record.key.containerEntityId = entity.containerEntityId;
+    record.key.containerEntityInstance = entity.containerEntityInstance;
+    get_sdr::key::set_flags(entity.isList, entity.isLinked, &(record.key));
+    record.key.entityId1 = entity.containedEntities[0].first;
+    record.key.entityInstance1 = entity.containedEntities[0].second;
 
     /* Body */
-    record.body.entityId2 = entity->second.containedEntities[1].first;
-    record.body.entityInstance2 = entity->second.containedEntities[1].second;
-    record.body.entityId3 = entity->second.containedEntities[2].first;
-    record.body.entityInstance3 = entity->second.containedEntities[2].second;
-    record.body.entityId4 = entity->second.containedEntities[3].first;
-    record.body.entityInstance4 = entity->second.containedEntities[3].second;
-
-    if (++entity == entityRecords.end())
-    {
-        get_sdr::response::set_next_record_id(END_OF_RECORD,
-                                              resp); // last record
-    }
-    else
-    {
-        get_sdr::response::set_next_record_id(
-            (ENTITY_RECORD_ID_START + entity->first), resp);
-    }
-
-    // Check for invalid offset size
-    if (req->offset > sizeof(record))
-    {
-        return IPMI_CC_PARM_OUT_OF_RANGE;
-    }
-
-    dataLength = std::min(static_cast<size_t>(req->bytes_to_read),
-                          sizeof(record) - req->offset);
-
-    std::memcpy(resp->record_data,
-                reinterpret_cast<uint8_t*>(&record) + req->offset, dataLength);
-
-    *data_len = dataLength;
-    *data_len += 2; // additional 2 bytes for next record ID
-
-    return IPMI_CC_OK;
+    record.body.entityId2 = entity.containedEntities[1].first;
+    record.body.entityInstance2 = entity.containedEntities[1].second;
+    record.body.entityId3 = entity.containedEntities[2].first;
+    record.body.entityInstance3 = entity.containedEntities[2].second;
+    record.body.entityId4 = entity.containedEntities[3].first;
+    record.body.entityInstance4 = entity.containedEntities[3].second;
+
+    return record;
 }
 
-ipmi_ret_t ipmi_sen_get_sdr(ipmi_netfn_t netfn, ipmi_cmd_t cmd,
-                            ipmi_request_t request, ipmi_response_t response,
-                            ipmi_data_len_t data_len, ipmi_context_t context)
+namespace
 {
-    ipmi_ret_t ret = IPMI_CC_OK;
-    get_sdr::GetSdrReq* req = (get_sdr::GetSdrReq*)request;
-    get_sdr::GetSdrResp* resp = (get_sdr::GetSdrResp*)response;
-    get_sdr::SensorDataFullRecord record = {0};
 
-    // Note: we use an iterator so we can provide the next ID at the end of
-    // the call.
-    auto sensor = ipmi::sensor::sensors.begin();
-    auto recordID = get_sdr::request::get_record_id(req);
+// Where a record is in the SDR image, and the record after it
+struct SdrRecord
+{
+    size_t offset;
+    size_t length;
+    uint16_t nextRecordID;
+};
 
-    // At the beginning of a scan, the host side will send us id=0.
-    if (recordID != 0)
+// All the records of the full, FRU and entity tables, in record ID order
+struct SdrRepository
+{
+    std::vector<uint8_t> image;
+    boost::container::flat_map<uint16_t, SdrRecord> records;
+
+    template <typename Record>
+    void add(uint16_t recordID, const Record& record)
     {
-        // recordID 0 to 255 means it is a FULL record.
-        // recordID 256 to 511 means it is a FRU record.
-        // recordID greater then 511 means it is a Entity Association
-        // record. Currently we are supporting three record types: FULL
-        // record, FRU record and Enttiy Association record.
-        if (recordID >= ENTITY_RECORD_ID_START)
+        if (!records.empty())
         {
-            return ipmi_entity_get_sdr(request, response, data_len);
+            records.rbegin()->second.nextRecordID = recordID;
         }
-        else if (recordID >= FRU_RECORD_ID_START &&
-                 recordID < ENTITY_RECORD_ID_START)
+        records.emplace(recordID,
+                        SdrRecord{image.size(), sizeof(record), END_OF_RECORD});
+        const auto* data = reinterpret_cast<const uint8_t*>(&record);
+        image.insert(image.end(), data, data + sizeof(record));
+    }
+};
+
+/** @brief Get the SDR repository of the generated tables
+ *
+ *  None of the record fields change at runtime, so each record is built
+ *  once, on the first Get SDR, and later reads only copy out of the image.
+ *
+ *  @return the repository
+ */
+const SdrRepository& sdrRepository()
+{
+    static const SdrRepository repository = []() {
+        SdrRepository repository;
+        for (const auto& [sensor_id, info] : ipmi::sensor::sensors)
         {
-            return ipmi_fru_get_sdr(request, response, data_len);
+            repository.add(sensor_id, makeFullRecord(sensor_id, info));
         }
-        else
+        for (const auto& [fruID, fru] : frus)
         {
-            sensor = ipmi::sensor::sensors.find(recordID);
-            if (sensor == ipmi::sensor::sensors.end())
+            // The FRU records are followed by the entity records
+            if (FRU_RECORD_ID_START + fruID >= ENTITY_RECORD_ID_START)
             {
-                return IPMI_CC_SENSOR_INVALID;
+                break;
             }
+            repository.add(FRU_RECORD_ID_START + fruID,
+                           makeFruRecord(fruID, fru));
         }
-    }
+        const auto& entityRecords =
+            ipmi::sensor::EntityInfoMapContainer::getContainer()
+                ->getIpmiEntityRecords();
+        for (const auto& [entityRecordID, entity] : entityRecords)
+        {
+            repository.add(ENTITY_RECORD_ID_START + entityRecordID,
+                           makeEntityRecord(entityRecordID, entity));
+        }
+        return repository;
+    }();
+    return repository;
+}
 
-    uint8_t sensor_id = sensor->first;
+} // namespace
 
-    /* Header */
-    get_sdr::header::set_record_id(sensor_id, &(record.header));
-    record.header.sdr_version = 0x51; // Based on IPMI Spec v2.0 rev 1.1
-    record.header.record_type = get_sdr::SENSOR_DATA_FULL_RECORD;
-    record.header.record_length = sizeof(record.key) + sizeof(record.body);
+ipmi_ret_t ipmi_sen_get_sdr(ipmi_netfn_t netfn, ipmi_cmd_t cmd,
+                            ipmi_request_t request, ipmi_response_t response,
+                            ipmi_data_len_t data_len, ipmi_context_t context)
+{
+    get_sdr::GetSdrReq* req = (get_sdr::GetSdrReq*)request;
+    get_sdr::GetSdrResp* resp = (get_sdr::GetSdrResp*)response;
+    const auto& repository = sdrRepository();
 
-    /* Key */
-    get_sdr::key::set_owner_id_bmc(&(record.key));
-    record.key.sensor_number = sensor_id;
+    // recordID 0 to 255 means it is a FULL record.
+    // recordID 256 to 511 means it is a FRU record.
+    // recordID greater then 511 means it is a Entity Association
+    // record. Currently we are supporting three record types: FULL
+    // record, FRU record and Enttiy Association record.
+    auto recordID = get_sdr::request::get_record_id(req);
 
-    /* Body */
-    record.body.entity_id = sensor->second.entityType;
-    record.body.sensor_type = sensor->second.sensorType;
-    record.body.event_reading_type = sensor->second.sensorReadingType;
-    record.body.entity_instance = sensor->second.instance;
-    if (ipmi::sensor::Mutability::Write ==
-        (sensor->second.mutability & ipmi::sensor::Mutability::Write))
+    // At the beginning of a scan, the host side will send us id=0.
+    auto record = recordID == 0 ? repository.records.begin()
+                                : repository.records.find(recordID);
+    if (record == repository.records.end())
     {
-        get_sdr::body::init_settable_state(true, &(record.body));
+        return IPMI_CC_SENSOR_INVALID;
     }
 
-    // Set the type-specific details given the DBus interface
-    ret =
-        populate_record_from_dbus(&(record.body), &(sensor->second), data_len);
-
-    if (++sensor == ipmi::sensor::sensors.end())
-    {
-        // we have reached till end of sensor, so assign the next record id
-        // to 256(Max Sensor ID = 255) + FRU ID(may start with 0).
-        auto next_record_id = (frus.size())
-                                  ? frus.begin()->first + FRU_RECORD_ID_START
-                                  : END_OF_RECORD;
-
-        get_sdr::response::set_next_record_id(next_record_id, resp);
-    }
-    else
-    {
-        get_sdr::response::set_next_record_id(sensor->first, resp);
-    }
+    get_sdr::response::set_next_record_id(record->second.nextRecordID, resp);
 
-    if (req->offset > sizeof(record))
+    if (req->offset > record->second.length)
     {
         return IPMI_CC_PARM_OUT_OF_RANGE;
     }
@@ -996,16 +970,17 @@ ipmi_ret_t ipmi_sen_get_sdr(ipmi_netfn_t netfn, ipmi_cmd_t cmd,
     // data_len will ultimately be the size of the record, plus
     // the size of the next record ID:
     *data_len = std::min(static_cast<size_t>(req->bytes_to_read),
-                         sizeof(record) - req->offset);
+                         record->second.length - req->offset);
 
     std::memcpy(resp->record_data,
-                reinterpret_cast<uint8_t*>(&record) + req->offset, *data_len);
+                repository.image.data() + record->second.offset + req->offset,
+                *data_len);
 
     // data_len should include the LSB and MSB:
     *data_len +=
         sizeof(resp->next_record_id_lsb) + sizeof(resp->next_record_id_msb);
 
-    return ret;
+    return IPMI_CC_OK;
 }
 
 static bool isFromSystemChannel()
@@ -1016,6 +991,36 @@ static bool isFromSystemChannel()
     return true;
 }
 
+// Service providing the IPMI SEL add method, looked up on first use
+static std::string ipmiSELAddService;
+
+// Add a SEL entry through the IPMI SEL logger, without waiting for it
+static void addIpmiSel(const std::string& sensorPath,
+                       const std::vector<uint8_t>& eventData, bool assert,
+                       uint16_t generatorID, ipmi::sel::SELQueue::Done done)
+{
+    std::shared_ptr<sdbusplus::asio::connection> busp = getSdBus();
+    if (ipmiSELAddService.empty())
+    {
+        ipmiSELAddService =
+            ipmi::getService(*busp, ipmiSELAddInterface, ipmiSELPath);
+    }
+    busp->async_method_call(
+        [done{std::move(done)}](boost::system::error_code ec,
+                                uint16_t /* recordID */) {
+            if (ec)
+            {
+                log<level::ERR>("Failed to add SEL entry",
+                                entry("ERROR=%s", ec.message().c_str()));
+                // The logger may have been restarted elsewhere
+                ipmiSELAddService.clear();
+            }
+            done(!ec);
+        },
+        ipmiSELAddService, ipmiSELPath, ipmiSELAddInterface, "IpmiSelAdd",
+        ipmiSELAddMessage, sensorPath, eventData, assert, generatorID);
+}
+
 ipmi_ret_t ipmicmdPlatformEvent(ipmi_netfn_t netfn, ipmi_cmd_t cmd,
                                 ipmi_request_t request,
                                 ipmi_response_t response,
@@ -1079,27 +1084,51 @@ ipmi_ret_t ipmicmdPlatformEvent(ipmi_netfn_t netfn, ipmi_cmd_t cmd,
     assert = req->eventDirectionType & directionMask ? false : true;
     std::vector<uint8_t> eventData(req->data, req->data + count);
 
-    sdbusplus::bus::bus dbus(bus);
-    std::string service =
-        ipmi::getService(dbus, ipmiSELAddInterface, ipmiSELPath);
-    sdbusplus::message::message writeSEL = dbus.new_method_call(
-        service.c_str(), ipmiSELPath, ipmiSELAddInterface, "IpmiSelAdd");
-    writeSEL.append(ipmiSELAddMessage, sensorPath, eventData, assert,
-                    generatorID);
-    try
+    // Set BMC Global Enables can turn off logging the events received
+    if (!ipmid_get_host_event_buffer().systemEventLogging())
     {
-        dbus.call(writeSEL);
+        return IPMI_CC_OK;
     }
-    catch (sdbusplus::exception_t& e)
+
+    // Answer the host now, the SEL entry is added from the SEL queue
+    if (!ipmi::sel::getSELQueue().push(
+            [sensorPath, eventData, assert,
+             generatorID](ipmi::sel::SELQueue::Done done) {
+                addIpmiSel(sensorPath, eventData, assert, generatorID,
+                           std::move(done));
+            }))
     {
-        phosphor::logging::log<phosphor::logging::level::ERR>(e.what());
-        return IPMI_CC_UNSPECIFIED_ERROR;
+        return IPMI_CC_BUSY;
     }
     return IPMI_CC_OK;
 }
 
+static constexpr auto sensorUpdatesPath =
+    "/xyz/openbmc_project/Ipmi/SensorUpdates";
+static constexpr auto sensorUpdatesIntf =
+    "xyz.openbmc_project.Ipmi.SensorUpdates";
+
+// Put the counters of the Set Sensor Reading updates on D-Bus: waiting
+// now, queued, coalesced, sent and failed
+static void registerSensorUpdates()
+{
+    static std::shared_ptr<sdbusplus::asio::dbus_interface> iface =
+        getObjectServer()->add_interface(sensorUpdatesPath,
+                                         sensorUpdatesIntf);
+
+    iface->register_method("GetCounters", []() {
+        const auto& stats = ipmi::sensor::updateStatistics();
+        return std::make_tuple(
+            static_cast<uint32_t>(ipmi::sensor::pendingUpdates()),
+            stats.queued, stats.coalesced, stats.sent, stats.failed);
+    });
+    iface->initialize();
+}
+
 void register_netfn_sen_functions()
 {
+    registerSensorUpdates();
+
     // <Platform Event Message>
     ipmi_register_callback(NETFUN_SENSOR, IPMI_CMD_PLATFORM_EVENT, nullptr,
                            ipmicmdPlatformEvent, PRIVILEGE_OPERATOR);
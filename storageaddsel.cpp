@@ -1,6 +1,7 @@
 #include "elog-errors.hpp"
 #include "error-HostEvent.hpp"
 #include "sensorhandler.hpp"
+#include "storageaddsel.hpp"
 #include "storagehandler.hpp"
 
 #include <mapper.h>
@@ -10,11 +11,14 @@
 #include <cstdlib>
 #include <cstring>
 #include <fstream>
+#include <functional>
 #include <iostream>
 #include <ipmid/api.hpp>
 #include <ipmid/types.hpp>
+#include <map>
 #include <memory>
 #include <phosphor-logging/elog.hpp>
+#include <string>
 #include <vector>
 #include <xyz/openbmc_project/Logging/Entry/server.hpp>
 
@@ -42,27 +46,43 @@ std::string readESEL(const char* fileName)
     return content;
 }
 
-void createProcedureLogEntry(uint8_t procedureNum)
+// Each byte in eSEL is formatted as %02x with a space between bytes
+static std::string formatESEL(const std::string& eSELData)
 {
-    // Read the eSEL data from the file.
-    static constexpr auto eSELFile = "/tmp/esel";
-    auto eSELData = readESEL(eSELFile);
-
-    // Each byte in eSEL is formatted as %02x with a space between bytes and
-    // insert '/0' at the end of the character array.
     static constexpr auto byteSeparator = 3;
-    std::unique_ptr<char[]> data(
-        new char[(eSELData.size() * byteSeparator) + 1]());
-
+    std::string data(eSELData.size() * byteSeparator, ' ');
+    char byte[byteSeparator + 1];
     for (size_t i = 0; i < eSELData.size(); i++)
     {
-        sprintf(&data[i * byteSeparator], "%02x ", eSELData[i]);
+        snprintf(byte, sizeof(byte), "%02x ",
+                 static_cast<uint8_t>(eSELData[i]));
+        data.replace(i * byteSeparator, byteSeparator, byte);
     }
-    data[eSELData.size() * byteSeparator] = '\0';
+    return data;
+}
 
+void createProcedureLogEntry(uint8_t procedureNum,
+                             const std::string& eSELData,
+                             std::function<void(bool success)> done)
+{
     using error = sdbusplus::org::open_power::Host::Error::MaintenanceProcedure;
     using metadata = org::open_power::Host::MaintenanceProcedure;
 
-    report<error>(metadata::ESEL(data.get()),
-                  metadata::PROCEDURE(static_cast<uint32_t>(procedureNum)));
+    // The same entry report<> makes, through the logging service's Create
+    // method so that nothing waits for it
+    std::map<std::string, std::string> additionalData{
+        {metadata::ESEL::str_short, formatESEL(eSELData)},
+        {metadata::PROCEDURE::str_short, std::to_string(procedureNum)}};
+    getSdBus()->async_method_call(
+        [done{std::move(done)}](boost::system::error_code ec) {
+            if (ec)
+            {
+                log<level::ERR>("Failed to create the procedure log entry",
+                                entry("ERROR=%s", ec.message().c_str()));
+            }
+            done(!ec);
+        },
+        "xyz.openbmc_project.Logging", "/xyz/openbmc_project/logging",
+        "xyz.openbmc_project.Logging.Create", "Create", error::errName,
+        convertForMessage(Entry::Level::Error), additionalData);
 }
@@ -2,6 +2,12 @@
 
 #include <stdint.h>
 
+#include <functional>
+#include <string>
+
+// File holding the eSEL data sent by the host
+static constexpr auto eSELFile = "/tmp/esel";
+
 /** @brief Read eSEL data into a string
  *
  *  @param[in] filename - filename of file containing eSEL
@@ -10,8 +16,14 @@
  */
 std::string readESEL(const char* filename);
 
-/** @brief Create a log entry with maintenance procedure
+/** @brief Create a log entry with maintenance procedure from eSEL data
+ *         already read, without waiting for the logging service
  *
  *  @param[in] procedureNum - procedure number associated with the log entry
+ *  @param[in] eSELData - eSEL data, as returned by readESEL()
+ *  @param[in] done - called once the logging service created the entry,
+ *                    or failed to
  */
-void createProcedureLogEntry(uint8_t procedureNum);
+void createProcedureLogEntry(uint8_t procedureNum,
+                             const std::string& eSELData,
+                             std::function<void(bool success)> done);
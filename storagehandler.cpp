@@ -1,7 +1,9 @@
 #include "storagehandler.hpp"
 
 #include "fruread.hpp"
+#include "host-event-buffer.hpp"
 #include "read_fru_data.hpp"
+#include "selqueue.hpp"
 #include "selutility.hpp"
 #include "sensorhandler.hpp"
 #include "storageaddsel.hpp"
@@ -11,16 +13,22 @@
 #include <systemd/sd-bus.h>
 
 #include <algorithm>
+#include <charconv>
 #include <chrono>
 #include <cstdio>
 #include <cstring>
 #include <filesystem>
 #include <ipmid/api.hpp>
 #include <ipmid/utils.hpp>
+#include <memory>
+#include <optional>
 #include <phosphor-logging/elog-errors.hpp>
 #include <phosphor-logging/log.hpp>
+#include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/server.hpp>
 #include <string>
+#include <string_view>
+#include <tuple>
 #include <variant>
 #include <xyz/openbmc_project/Common/error.hpp>
 
@@ -46,26 +54,327 @@ constexpr auto PROPERTY_ELAPSED = "Elapsed";
 
 } // namespace
 
+using InternalFailure =
+    sdbusplus::xyz::openbmc_project::Common::Error::InternalFailure;
+using namespace phosphor::logging;
+using namespace ipmi::fru;
+
 namespace cache
 {
 /*
- * This cache contains the object paths of the logging entries sorted in the
- * order of the filename(numeric order). The cache is initialized by
- * invoking readLoggingObjectPaths with the cache as the parameter. The
- * cache is invoked in the execution of the Get SEL info and Delete SEL
- * entry command. The Get SEL Info command is typically invoked before the
- * Get SEL entry command, so the cache is utilized for responding to Get SEL
- * entry command. The cache is invalidated by clearing after Delete SEL
- * entry and Clear SEL command.
+ * This cache contains the logging entries in the numeric order of their
+ * IDs, which are also their SEL record IDs, together with the SEL records
+ * converted from them. It is filled by one GetManagedObjects call on first
+ * use, after that the InterfacesAdded, InterfacesRemoved and
+ * PropertiesChanged signals of the logging service keep it current, so the
+ * SEL commands are answered from memory. A record is found by binary
+ * search and the next record ID is the following element. The cache is
+ * read again after the Clear SEL command.
  */
-ipmi::sel::ObjectPaths paths;
+struct Entry
+{
+    uint32_t id;
+    // Seconds since epoch, for the Get SEL Info add timestamp
+    uint32_t timestamp;
+    // The record is converted and still current
+    bool converted;
+    ipmi::sel::GetSELEntryResponse record;
+};
+
+std::vector<Entry> entries;
+bool valid = false;
+std::unique_ptr<sdbusplus::bus::match::match> entryAdded;
+std::unique_ptr<sdbusplus::bus::match::match> entryRemoved;
+std::unique_ptr<sdbusplus::bus::match::match> entryChanged;
+
+std::string entryPath(uint32_t id)
+{
+    return std::string(ipmi::sel::logBasePath) + "/" + std::to_string(id);
+}
+
+// Logging entry ID of an object path, if it is a logging entry
+std::optional<uint32_t> entryID(std::string_view path)
+{
+    std::string_view base(ipmi::sel::logBasePath);
+    if (path.size() <= base.size() + 1 ||
+        path.substr(0, base.size()) != base || path[base.size()] != '/')
+    {
+        return std::nullopt;
+    }
+    std::string_view name = path.substr(base.size() + 1);
+    uint32_t id = 0;
+    const char* last = name.data() + name.size();
+    auto [end, ec] = std::from_chars(name.data(), last, id);
+    if (ec != std::errc() || end != last)
+    {
+        return std::nullopt;
+    }
+    return id;
+}
+
+bool byID(const Entry& entry, uint32_t id)
+{
+    return entry.id < id;
+}
+
+std::vector<Entry>::iterator find(uint32_t id)
+{
+    auto pos = std::lower_bound(entries.begin(), entries.end(), id, byID);
+    if (pos != entries.end() && pos->id != id)
+    {
+        return entries.end();
+    }
+    return pos;
+}
+
+// An entry converted from its properties. If that fails, the conversion
+// is retried and the error reported when the record is asked for.
+Entry makeEntry(uint32_t id, const ipmi::sel::EntryInterfaces& interfaces)
+{
+    Entry entry{id, ipmi::sel::invalidTimeStamp, false, {}};
+    try
+    {
+        entry.timestamp = static_cast<uint32_t>(
+            ipmi::sel::getEntryTimeStamp(interfaces).count());
+        entry.record = ipmi::sel::convertLogEntrytoSEL(interfaces);
+        entry.converted = true;
+    }
+    catch (const std::exception& e)
+    {
+    }
+    return entry;
+}
+
+void add(Entry&& entry)
+{
+    // New entries normally have the highest ID
+    if (entries.empty() || entries.back().id < entry.id)
+    {
+        entries.push_back(std::move(entry));
+        return;
+    }
+    auto pos =
+        std::lower_bound(entries.begin(), entries.end(), entry.id, byID);
+    if (pos->id == entry.id)
+    {
+        *pos = std::move(entry);
+    }
+    else
+    {
+        entries.insert(pos, std::move(entry));
+    }
+}
+
+void remove(uint32_t id)
+{
+    auto pos = find(id);
+    if (pos != entries.end())
+    {
+        entries.erase(pos);
+    }
+}
+
+void invalidate()
+{
+    valid = false;
+    entries.clear();
+}
+
+const ipmi::sel::GetSELEntryResponse& record(Entry& entry)
+{
+    if (!entry.converted)
+    {
+        entry.record = ipmi::sel::convertLogEntrytoSEL(entryPath(entry.id));
+        entry.converted = true;
+    }
+    return entry.record;
+}
+
+void watch()
+{
+    std::shared_ptr<sdbusplus::asio::connection> bus = getSdBus();
+    entryAdded = std::make_unique<sdbusplus::bus::match::match>(
+        *bus,
+        sdbusplus::bus::match::rules::interfacesAdded(ipmi::sel::logObjPath),
+        [](sdbusplus::message::message& m) {
+            sdbusplus::message::object_path path;
+            ipmi::sel::EntryInterfaces interfaces;
+            try
+            {
+                m.read(path, interfaces);
+            }
+            catch (const sdbusplus::exception::SdBusError& e)
+            {
+                // Converted when it is first asked for
+                interfaces.clear();
+            }
+            std::optional<uint32_t> id = entryID(path.str);
+            phosphor::host::event::Buffer& buffer =
+                ipmid_get_host_event_buffer();
+            if (!id || (!valid && !buffer.enabled()))
+            {
+                return;
+            }
+            Entry added = makeEntry(*id, interfaces);
+            // Only the BMC's own events go to the host's Event Message
+            // Buffer, not the ones the host logged itself
+            if (added.converted && ipmi::sel::isBMCEvent(added.record))
+            {
+                phosphor::host::event::Message message;
+                static_assert(sizeof(added.record.event) == message.size());
+                std::memcpy(message.data(), &added.record.event,
+                            message.size());
+                buffer.push(message);
+            }
+            if (valid)
+            {
+                add(std::move(added));
+            }
+        });
+    entryRemoved = std::make_unique<sdbusplus::bus::match::match>(
+        *bus,
+        sdbusplus::bus::match::rules::interfacesRemoved(ipmi::sel::logObjPath),
+        [](sdbusplus::message::message& m) {
+            sdbusplus::message::object_path path;
+            std::vector<std::string> interfaces;
+            try
+            {
+                m.read(path, interfaces);
+            }
+            catch (const sdbusplus::exception::SdBusError& e)
+            {
+                // The removed entry is unknown, read the IDs again
+                invalidate();
+                return;
+            }
+            std::optional<uint32_t> id = entryID(path.str);
+            if (id && valid &&
+                std::find(interfaces.begin(), interfaces.end(),
+                          ipmi::sel::logEntryIntf) != interfaces.end())
+            {
+                remove(*id);
+            }
+        });
+    // Resolving an entry turns its event into a deassertion
+    entryChanged = std::make_unique<sdbusplus::bus::match::match>(
+        *bus,
+        sdbusplus::bus::match::rules::type::signal() +
+            sdbusplus::bus::match::rules::member("PropertiesChanged") +
+            sdbusplus::bus::match::rules::interface(ipmi::sel::propIntf) +
+            sdbusplus::bus::match::rules::path_namespace(
+                ipmi::sel::logBasePath) +
+            sdbusplus::bus::match::rules::argN(0, ipmi::sel::logEntryIntf),
+        [](sdbusplus::message::message& m) {
+            std::optional<uint32_t> id = entryID(m.get_path());
+            if (!id || !valid)
+            {
+                return;
+            }
+            auto pos = find(*id);
+            if (pos != entries.end())
+            {
+                pos->converted = false;
+            }
+        });
+}
+
+std::vector<Entry>& getEntries()
+{
+    if (valid)
+    {
+        return entries;
+    }
+    // Watch before reading, so that no change falls in between
+    if (!entryAdded)
+    {
+        watch();
+    }
+
+    entries.clear();
+    ipmi::sel::LoggingObjects objects;
+    try
+    {
+        ipmi::sel::readLoggingObjects(objects);
+        for (const auto& [path, interfaces] : objects)
+        {
+            std::optional<uint32_t> id = entryID(path.str);
+            if (id && interfaces.count(ipmi::sel::logEntryIntf))
+            {
+                entries.push_back(makeEntry(*id, interfaces));
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        log<level::ERR>("Error in reading logging objects, reading paths",
+                        entry("ERROR=%s", e.what()));
+        entries.clear();
+        ipmi::sel::ObjectPaths paths;
+        try
+        {
+            ipmi::sel::readLoggingObjectPaths(paths);
+        }
+        catch (const sdbusplus::exception::SdBusError& e)
+        {
+            // readLoggingObjectPaths will throw exception if there are no
+            // log entries.
+        }
+        for (const std::string& path : paths)
+        {
+            if (std::optional<uint32_t> id = entryID(path))
+            {
+                entries.push_back(
+                    Entry{*id, ipmi::sel::invalidTimeStamp, false, {}});
+            }
+        }
+    }
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return a.id < b.id; });
+    valid = true;
+    return entries;
+}
 
 } // namespace cache
 
-using InternalFailure =
-    sdbusplus::xyz::openbmc_project::Common::Error::InternalFailure;
-using namespace phosphor::logging;
-using namespace ipmi::fru;
+namespace ipmi
+{
+namespace sel
+{
+
+SELQueue& getSELQueue()
+{
+    static SELQueue queue(*getIoContext());
+    return queue;
+}
+
+} // namespace sel
+} // namespace ipmi
+
+static constexpr auto selQueuePath = "/xyz/openbmc_project/Ipmi/SELQueue";
+static constexpr auto selQueueIntf = "xyz.openbmc_project.Ipmi.SELQueue";
+
+using SELQueueCounters =
+    std::tuple<uint32_t, uint32_t, uint64_t, uint64_t, uint64_t>;
+
+// Put the SEL queue counters on D-Bus: depth, high water mark, and the
+// writes dropped because the queue was full, persisted and failed
+static void registerSELQueue()
+{
+    static std::shared_ptr<sdbusplus::asio::dbus_interface> iface =
+        getObjectServer()->add_interface(selQueuePath, selQueueIntf);
+
+    iface->register_property(
+        "Capacity",
+        static_cast<uint32_t>(ipmi::sel::getSELQueue().capacity()));
+    iface->register_method("GetCounters", []() {
+        const ipmi::sel::SELQueue& queue = ipmi::sel::getSELQueue();
+        return SELQueueCounters(queue.depth(), queue.highWater(),
+                                queue.dropped(), queue.written(),
+                                queue.failed());
+    });
+    iface->initialize();
+}
+
 
 /**
  * @enum Device access mode
@@ -105,26 +414,21 @@ ipmi::RspType<uint8_t,  // SEL revision.
     // Most recent addition timestamp.
     uint32_t addTimeStamp = ipmi::sel::invalidTimeStamp;
 
-    try
+    const std::vector<cache::Entry>& selEntries = cache::getEntries();
+    if (!selEntries.empty())
     {
-        ipmi::sel::readLoggingObjectPaths(cache::paths);
-    }
-    catch (const sdbusplus::exception::SdBusError& e)
-    {
-        // No action if reading log objects have failed for this command.
-        // readLoggingObjectPaths will throw exception if there are no log
-        // entries. The command will be responded with number of SEL entries
-        // as 0.
+        entries = static_cast<uint16_t>(selEntries.size());
+        addTimeStamp = selEntries.back().timestamp;
     }
 
-    if (!cache::paths.empty())
+    if (addTimeStamp == ipmi::sel::invalidTimeStamp && !selEntries.empty())
     {
-        entries = static_cast<uint16_t>(cache::paths.size());
-
         try
         {
             addTimeStamp = static_cast<uint32_t>(
-                (ipmi::sel::getEntryTimeStamp(cache::paths.back()).count()));
+                (ipmi::sel::getEntryTimeStamp(
+                     cache::entryPath(selEntries.back().id))
+                     .count()));
         }
         catch (InternalFailure& e)
         {
@@ -171,30 +475,28 @@ ipmi_ret_t getSELEntry(ipmi_netfn_t netfn, ipmi_cmd_t cmd,
         }
     }
 
-    if (cache::paths.empty())
+    std::vector<cache::Entry>& selEntries = cache::getEntries();
+    if (selEntries.empty())
     {
         *data_len = 0;
         return IPMI_CC_SENSOR_INVALID;
     }
 
-    ipmi::sel::ObjectPaths::const_iterator iter;
+    std::vector<cache::Entry>::iterator iter;
 
     // Check for the requested SEL Entry.
     if (requestData->selRecordID == ipmi::sel::firstEntry)
     {
-        iter = cache::paths.begin();
+        iter = selEntries.begin();
     }
     else if (requestData->selRecordID == ipmi::sel::lastEntry)
     {
-        iter = cache::paths.end();
+        iter = selEntries.end() - 1;
     }
     else
     {
-        std::string objPath = std::string(ipmi::sel::logBasePath) + "/" +
-                              std::to_string(requestData->selRecordID);
-
-        iter = std::find(cache::paths.begin(), cache::paths.end(), objPath);
-        if (iter == cache::paths.end())
+        iter = cache::find(requestData->selRecordID);
+        if (iter == selEntries.end())
         {
             *data_len = 0;
             return IPMI_CC_SENSOR_INVALID;
@@ -203,10 +505,10 @@ ipmi_ret_t getSELEntry(ipmi_netfn_t netfn, ipmi_cmd_t cmd,
 
     ipmi::sel::GetSELEntryResponse record{};
 
-    // Convert the log entry into SEL record.
+    // The log entry converted into SEL record.
     try
     {
-        record = ipmi::sel::convertLogEntrytoSEL(*iter);
+        record = cache::record(*iter);
     }
     catch (InternalFailure& e)
     {
@@ -221,24 +523,14 @@ ipmi_ret_t getSELEntry(ipmi_netfn_t netfn, ipmi_cmd_t cmd,
     }
 
     // Identify the next SEL record ID
-    if (iter != cache::paths.end())
+    ++iter;
+    if (iter == selEntries.end())
     {
-        ++iter;
-        if (iter == cache::paths.end())
-        {
-            record.nextRecordID = ipmi::sel::lastEntry;
-        }
-        else
-        {
-            namespace fs = std::filesystem;
-            fs::path path(*iter);
-            record.nextRecordID = static_cast<uint16_t>(
-                std::stoul(std::string(path.filename().c_str())));
-        }
+        record.nextRecordID = ipmi::sel::lastEntry;
     }
     else
     {
-        record.nextRecordID = ipmi::sel::lastEntry;
+        record.nextRecordID = static_cast<uint16_t>(iter->id);
     }
 
     if (requestData->readLength == ipmi::sel::entireRecord)
@@ -283,9 +575,6 @@ ipmi::RspType<uint16_t // deleted record ID
               >
     deleteSELEntry(uint16_t reservationID, uint16_t selRecordID)
 {
-
-    namespace fs = std::filesystem;
-
     if (!checkSELReservation(reservationID))
     {
         return ipmi::responseInvalidReservationId();
@@ -295,58 +584,38 @@ ipmi::RspType<uint16_t // deleted record ID
     // deleted
     cancelSELReservation();
 
-    try
+    const std::vector<cache::Entry>& selEntries = cache::getEntries();
+    if (selEntries.empty())
     {
-        ipmi::sel::readLoggingObjectPaths(cache::paths);
-    }
-    catch (const sdbusplus::exception::SdBusError& e)
-    {
-        // readLoggingObjectPaths will throw exception if there are no error
-        // log entries.
         return ipmi::responseSensorInvalid();
     }
 
-    if (cache::paths.empty())
-    {
-        return ipmi::responseSensorInvalid();
-    }
-
-    ipmi::sel::ObjectPaths::const_iterator iter;
-    uint16_t delRecordID = 0;
+    uint32_t delID = 0;
 
     if (selRecordID == ipmi::sel::firstEntry)
     {
-        iter = cache::paths.begin();
-        fs::path path(*iter);
-        delRecordID = static_cast<uint16_t>(
-            std::stoul(std::string(path.filename().c_str())));
+        delID = selEntries.front().id;
     }
     else if (selRecordID == ipmi::sel::lastEntry)
     {
-        iter = cache::paths.end();
-        fs::path path(*iter);
-        delRecordID = static_cast<uint16_t>(
-            std::stoul(std::string(path.filename().c_str())));
+        delID = selEntries.back().id;
     }
     else
     {
-        std::string objPath = std::string(ipmi::sel::logBasePath) + "/" +
-                              std::to_string(selRecordID);
-
-        iter = std::find(cache::paths.begin(), cache::paths.end(), objPath);
-        if (iter == cache::paths.end())
+        if (cache::find(selRecordID) == selEntries.end())
         {
             return ipmi::responseSensorInvalid();
         }
-        delRecordID = selRecordID;
+        delID = selRecordID;
     }
+    std::string delPath = cache::entryPath(delID);
 
     sdbusplus::bus::bus bus{ipmid_get_sd_bus_connection()};
     std::string service;
 
     try
     {
-        service = ipmi::getService(bus, ipmi::sel::logDeleteIntf, *iter);
+        service = ipmi::getService(bus, ipmi::sel::logDeleteIntf, delPath);
     }
     catch (const std::runtime_error& e)
     {
@@ -354,7 +623,7 @@ ipmi::RspType<uint16_t // deleted record ID
         return ipmi::responseUnspecifiedError();
     }
 
-    auto methodCall = bus.new_method_call(service.c_str(), (*iter).c_str(),
+    auto methodCall = bus.new_method_call(service.c_str(), delPath.c_str(),
                                           ipmi::sel::logDeleteIntf, "Delete");
     auto reply = bus.call(methodCall);
     if (reply.is_method_error())
@@ -362,12 +631,137 @@ ipmi::RspType<uint16_t // deleted record ID
         return ipmi::responseUnspecifiedError();
     }
 
-    // Invalidate the cache of dbus entry objects.
-    cache::paths.clear();
+    // InterfacesRemoved follows, but the next command may come first
+    cache::remove(delID);
 
-    return ipmi::responseSuccess(delRecordID);
+    return ipmi::responseSuccess(static_cast<uint16_t>(delID));
 }
 
+namespace erase
+{
+
+// Logging entries being deleted at once when DeleteAll is not available
+constexpr size_t deleteWindow = 8;
+
+/*
+ * Clear SEL runs in the background, so that the other commands keep being
+ * served while thousands of logging entries go away. The logging manager
+ * is asked to DeleteAll entries in one call; if it does not implement
+ * that, the entries are deleted one by one with a few calls in flight.
+ * Get Erase Status reports in progress until the job is done.
+ */
+class Job : public std::enable_shared_from_this<Job>
+{
+  public:
+    void start();
+
+  private:
+    void deleteAll(const std::string& service);
+    void deleteEach();
+    void deleteNext();
+    void finish();
+
+    std::shared_ptr<sdbusplus::asio::connection> bus = getSdBus();
+    std::vector<ipmi::DbusObjectInfo> entries;
+    size_t nextEntry = 0;
+    size_t pending = 0;
+};
+
+bool inProgress = false;
+
+void Job::start()
+{
+    inProgress = true;
+    bus->async_method_call(
+        [self = shared_from_this()](
+            boost::system::error_code ec,
+            const std::map<std::string, std::vector<std::string>>& services) {
+            if (ec || services.empty())
+            {
+                self->deleteEach();
+                return;
+            }
+            self->deleteAll(services.begin()->first);
+        },
+        ipmi::sel::mapperBusName, ipmi::sel::mapperObjPath,
+        ipmi::sel::mapperIntf, "GetObject", ipmi::sel::logObjPath,
+        ipmi::sel::ObjectPaths({ipmi::sel::logDeleteAllIntf}));
+}
+
+void Job::deleteAll(const std::string& service)
+{
+    bus->async_method_call(
+        [self = shared_from_this()](boost::system::error_code ec) {
+            if (ec)
+            {
+                log<level::ERR>("DeleteAll of the logging entries failed",
+                                entry("ERROR=%s", ec.message().c_str()));
+                self->deleteEach();
+                return;
+            }
+            self->finish();
+        },
+        service, ipmi::sel::logObjPath, ipmi::sel::logDeleteAllIntf,
+        "DeleteAll");
+}
+
+void Job::deleteEach()
+{
+    auto depth = 0;
+    bus->async_method_call(
+        [self = shared_from_this()](boost::system::error_code ec,
+                                    const ipmi::ObjectTree& objectTree) {
+            if (!ec)
+            {
+                for (const auto& [path, services] : objectTree)
+                {
+                    if (!services.empty())
+                    {
+                        self->entries.emplace_back(path,
+                                                   services.begin()->first);
+                    }
+                }
+            }
+            self->deleteNext();
+        },
+        ipmi::sel::mapperBusName, ipmi::sel::mapperObjPath,
+        ipmi::sel::mapperIntf, "GetSubTree", ipmi::sel::logBasePath, depth,
+        ipmi::sel::ObjectPaths({ipmi::sel::logDeleteIntf}));
+}
+
+void Job::deleteNext()
+{
+    while (pending < deleteWindow && nextEntry < entries.size())
+    {
+        const auto& [path, service] = entries[nextEntry++];
+        pending++;
+        bus->async_method_call(
+            [self = shared_from_this()](boost::system::error_code ec) {
+                if (ec)
+                {
+                    log<level::ERR>("Failed to delete a logging entry",
+                                    entry("ERROR=%s", ec.message().c_str()));
+                }
+                self->pending--;
+                self->deleteNext();
+            },
+            service, path, ipmi::sel::logDeleteIntf, "Delete");
+    }
+    if (pending == 0 && nextEntry == entries.size())
+    {
+        finish();
+    }
+}
+
+void Job::finish()
+{
+    // Read the logging entries again, in case any signal went missing
+    cache::invalidate();
+    inProgress = false;
+}
+
+} // namespace erase
+
 /** @brief implements the Clear SEL command
  * @request
  *   - reservationID   // Reservation ID.
@@ -394,81 +788,28 @@ ipmi::RspType<uint8_t // erase status
         return ipmi::responseInvalidReservationId();
     }
 
-    /*
-     * Erasure status cannot be fetched from DBUS, so always return erasure
-     * status as `erase completed`.
-     */
     if (eraseOperation == ipmi::sel::getEraseStatus)
     {
-        return ipmi::responseSuccess(
-            static_cast<uint8_t>(ipmi::sel::eraseComplete));
+        return ipmi::responseSuccess(static_cast<uint8_t>(
+            erase::inProgress ? ipmi::sel::eraseInProgress
+                              : ipmi::sel::eraseComplete));
     }
 
-    // Per the IPMI spec, need to cancel any reservation when the SEL is cleared
-    cancelSELReservation();
-
-    sdbusplus::bus::bus bus{ipmid_get_sd_bus_connection()};
-    ipmi::sel::ObjectPaths objectPaths;
-    auto depth = 0;
-
-    auto mapperCall =
-        bus.new_method_call(ipmi::sel::mapperBusName, ipmi::sel::mapperObjPath,
-                            ipmi::sel::mapperIntf, "GetSubTreePaths");
-    mapperCall.append(ipmi::sel::logBasePath);
-    mapperCall.append(depth);
-    mapperCall.append(ipmi::sel::ObjectPaths({ipmi::sel::logEntryIntf}));
-
-    try
+    if (eraseOperation != ipmi::sel::initiateErase)
     {
-        auto reply = bus.call(mapperCall);
-        if (reply.is_method_error())
-        {
-            return ipmi::responseSuccess(
-                static_cast<uint8_t>(ipmi::sel::eraseComplete));
-        }
-
-        reply.read(objectPaths);
-        if (objectPaths.empty())
-        {
-            return ipmi::responseSuccess(
-                static_cast<uint8_t>(ipmi::sel::eraseComplete));
-        }
-    }
-    catch (const sdbusplus::exception::SdBusError& e)
-    {
-        return ipmi::responseSuccess(
-            static_cast<uint8_t>(ipmi::sel::eraseComplete));
+        return ipmi::responseInvalidFieldRequest();
     }
 
-    std::string service;
-
-    try
-    {
-        service = ipmi::getService(bus, ipmi::sel::logDeleteIntf,
-                                   objectPaths.front());
-    }
-    catch (const std::runtime_error& e)
-    {
-        log<level::ERR>(e.what());
-        return ipmi::responseUnspecifiedError();
-    }
+    // Per the IPMI spec, need to cancel any reservation when the SEL is cleared
+    cancelSELReservation();
 
-    for (const auto& iter : objectPaths)
+    // A second request while erasing just reports on the running one
+    if (!erase::inProgress)
     {
-        auto methodCall = bus.new_method_call(
-            service.c_str(), iter.c_str(), ipmi::sel::logDeleteIntf, "Delete");
-
-        auto reply = bus.call(methodCall);
-        if (reply.is_method_error())
-        {
-            return ipmi::responseUnspecifiedError();
-        }
+        std::make_shared<erase::Job>()->start();
     }
-
-    // Invalidate the cache of dbus entry objects.
-    cache::paths.clear();
     return ipmi::responseSuccess(
-        static_cast<uint8_t>(ipmi::sel::eraseComplete));
+        static_cast<uint8_t>(ipmi::sel::eraseInProgress));
 }
 
 /** @brief implements the get SEL time command
@@ -613,26 +954,23 @@ ipmi::RspType<uint16_t // recordID of the Added SEL entry
     if (recordType == procedureType)
     {
         // In the OEM record type 0xDE, byte 11 in the SEL record indicate the
-        // procedure number.
-        createProcedureLogEntry(sensorType);
+        // procedure number. The eSEL is read now, before the host can send
+        // the next one, and the log entry is created from the SEL queue.
+        bool queued = ipmi::sel::getSELQueue().push(
+            [sensorType, eSELData = readESEL(eSELFile)](
+                ipmi::sel::SELQueue::Done done) {
+                createProcedureLogEntry(sensorType, eSELData,
+                                        std::move(done));
+            });
+        if (!queued)
+        {
+            return ipmi::responseBusy();
+        }
     }
 
     return ipmi::responseSuccess(recordID);
 }
 
-bool isFruPresent(const std::string& fruPath)
-{
-    using namespace ipmi::fru;
-
-    sdbusplus::bus::bus bus{ipmid_get_sd_bus_connection()};
-
-    auto propValue =
-        ipmi::getDbusProperty(bus, invMgrInterface, invObjPath + fruPath,
-                              invItemInterface, itemPresentProp);
-
-    return std::get<bool>(propValue);
-}
-
 /** @brief implements the get FRU Inventory Area Info command
  *
  *  @returns IPMI completion code plus response data
@@ -642,7 +980,7 @@ bool isFruPresent(const std::string& fruPath)
 ipmi::RspType<uint16_t, // FRU Inventory area size in bytes,
               uint8_t   // access size (bytes / words)
               >
-    ipmiStorageGetFruInvAreaInfo(uint8_t fruID)
+    ipmiStorageGetFruInvAreaInfo(ipmi::Context::ptr ctx, uint8_t fruID)
 {
 
     auto iter = frus.find(fruID);
@@ -651,16 +989,15 @@ ipmi::RspType<uint16_t, // FRU Inventory area size in bytes,
         return ipmi::responseSensorInvalid();
     }
 
-    auto path = iter->second[0].path;
-    if (!isFruPresent(path))
-    {
-        return ipmi::responseSensorInvalid();
-    }
-
     try
     {
+        if (!ipmi::fru::isFruPresent(ctx, fruID))
+        {
+            return ipmi::responseSensorInvalid();
+        }
+
         return ipmi::responseSuccess(
-            static_cast<uint16_t>(getFruAreaData(fruID).size()),
+            static_cast<uint16_t>(getFruAreaData(ctx, fruID)->size()),
             static_cast<uint8_t>(AccessMode::bytes));
     }
     catch (const InternalFailure& e)
@@ -679,10 +1016,10 @@ ipmi::RspType<uint16_t, // FRU Inventory area size in bytes,
  * - returnCount - response data count.
  * - data        -  response data
  */
-ipmi::RspType<uint8_t,              // count returned
-              std::vector<uint8_t>> // FRU data
-    ipmiStorageReadFruData(uint8_t fruDeviceId, uint16_t offset,
-                           uint8_t readCount)
+ipmi::RspType<uint8_t,            // count returned
+              ipmi::SharedBytes> // FRU data
+    ipmiStorageReadFruData(ipmi::Context::ptr ctx, uint8_t fruDeviceId,
+                           uint16_t offset, uint8_t readCount)
 {
     if (fruDeviceId == 0xFF)
     {
@@ -697,8 +1034,8 @@ ipmi::RspType<uint8_t,              // count returned
 
     try
     {
-        const auto& fruArea = getFruAreaData(fruDeviceId);
-        auto size = fruArea.size();
+        auto fruArea = getFruAreaData(ctx, fruDeviceId);
+        auto size = fruArea->size();
 
         if (offset >= size)
         {
@@ -716,10 +1053,9 @@ ipmi::RspType<uint8_t,              // count returned
             returnCount = size - offset;
         }
 
-        std::vector<uint8_t> fruData((fruArea.begin() + offset),
-                                     (fruArea.begin() + offset + returnCount));
-
-        return ipmi::responseSuccess(returnCount, fruData);
+        return ipmi::responseSuccess(
+            returnCount,
+            ipmi::SharedBytes(std::move(fruArea), offset, returnCount));
     }
     catch (const InternalFailure& e)
     {
@@ -752,6 +1088,10 @@ ipmi::RspType<uint8_t,  // SDR version
 
 void register_netfn_storage_functions()
 {
+    registerSELQueue();
+    // New logging entries also feed the Event Message Buffer
+    cache::watch();
+
     // <Get SEL Info>
     ipmi::registerHandler(ipmi::prioOpenBmcBase, ipmi::netFnStorage,
                           ipmi::storage::cmdGetSelInfo, ipmi::Privilege::User,
@@ -815,5 +1155,6 @@ void register_netfn_storage_functions()
                            ipmi_sen_get_sdr, PRIVILEGE_USER);
 
     ipmi::fru::registerCallbackHandler();
+    ipmi::fru::prefetchFruAreas();
     return;
 }
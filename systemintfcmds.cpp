@@ -3,11 +3,13 @@
 #include "systemintfcmds.hpp"
 
 #include "host-cmd-manager.hpp"
+#include "host-event-buffer.hpp"
 #include "host-interface.hpp"
 
 #include <cstring>
 #include <ipmid-host/cmd.hpp>
 #include <ipmid/api.hpp>
+#include <optional>
 
 void register_netfn_app_functions() __attribute__((constructor));
 
@@ -17,6 +19,9 @@ using namespace sdbusplus::xyz::openbmc_project::Control::server;
 using cmdManagerPtr = std::unique_ptr<phosphor::host::command::Manager>;
 extern cmdManagerPtr& ipmid_get_host_cmd_manager();
 
+// Read Event Message Buffer completion code for an empty buffer
+constexpr ipmi_ret_t ccEventBufferEmpty = 0x80;
+
 //-------------------------------------------------------------------
 // Called by Host post response from Get_Message_Flags
 //-------------------------------------------------------------------
@@ -26,6 +31,25 @@ ipmi_ret_t ipmi_app_read_event(ipmi_netfn_t netfn, ipmi_cmd_t cmd,
 {
     ipmi_ret_t rc = IPMI_CC_OK;
 
+    // Commands for the host come first, then the Event Message Buffer
+    if (ipmid_get_host_cmd_manager()->empty())
+    {
+        phosphor::host::event::Buffer& buffer = ipmid_get_host_event_buffer();
+        if (std::optional<phosphor::host::event::Message> message =
+                buffer.pop())
+        {
+            *data_len = message->size();
+            std::memcpy(response, message->data(), *data_len);
+            return rc;
+        }
+        if (buffer.enabled())
+        {
+            // Drained. Otherwise this is answered with a heartbeat below
+            *data_len = 0;
+            return ccEventBufferEmpty;
+        }
+    }
+
     struct oem_sel_timestamped oem_sel = {0};
     *data_len = sizeof(struct oem_sel_timestamped);
 
@@ -57,19 +81,23 @@ ipmi_ret_t ipmi_app_read_event(ipmi_netfn_t netfn, ipmi_cmd_t cmd,
 }
 
 //---------------------------------------------------------------------
-// Called by Host on seeing a SMS_ATN bit set. Return a hardcoded
-// value of 0x2 indicating we need Host read some data.
+// Called by Host on seeing a SMS_ATN bit set. Return 0x2 when there is
+// a command or an event for the Host to read.
 //-------------------------------------------------------------------
 ipmi::RspType<uint8_t> ipmiAppGetMessageFlags()
 {
     // From IPMI spec V2.0 for Get Message Flags Command :
     // bit:[1] from LSB : 1b = Event Message Buffer Full.
-    // Return as 0 if Event Message Buffer is not supported,
-    // or when the Event Message buffer is disabled.
-    // This path is used to communicate messages to the host
+    // This path is also used to communicate messages to the host
     // from within the phosphor::host::command::Manager
     constexpr uint8_t setEventMsgBufferFull = 0x2;
-    return ipmi::responseSuccess(setEventMsgBufferFull);
+    uint8_t flags = 0;
+    if (!ipmid_get_host_cmd_manager()->empty() ||
+        !ipmid_get_host_event_buffer().empty())
+    {
+        flags |= setEventMsgBufferFull;
+    }
+    return ipmi::responseSuccess(flags);
 }
 
 ipmi::RspType<bool,    // Receive Message Queue Interrupt Enabled
@@ -83,8 +111,11 @@ ipmi::RspType<bool,    // Receive Message Queue Interrupt Enabled
               >
     ipmiAppGetBMCGlobalEnable()
 {
-    return ipmi::responseSuccess(true, false, false, true, 0, false, false,
-                                 false);
+    const phosphor::host::event::Buffer& buffer =
+        ipmid_get_host_event_buffer();
+    return ipmi::responseSuccess(true, buffer.fullInterruptEnabled(),
+                                 buffer.enabled(), buffer.systemEventLogging(),
+                                 0, false, false, false);
 }
 
 ipmi::RspType<> ipmiAppSetBMCGlobalEnable(
@@ -111,16 +142,19 @@ ipmi::RspType<> ipmiAppSetBMCGlobalEnable(
         return ipmi::responseCommandNotAvailable();
     }
 
-    // Recv Message Queue and SEL are enabled by default.
-    // Event Message buffer are disabled by default (not supported).
-    // Any request that try to change the mask will be rejected
-    if (!receiveMessageQueueInterruptEnabled || !systemEventLogEnable ||
-        eventMessageBufferFullInterruptEnabled || eventMessageBufferEnabled ||
-        OEM0Enabled || OEM1Enabled || OEM2Enabled || reserved)
+    // Recv Message Queue interrupt is always enabled and the OEM bits are
+    // not supported. Any request that try to change them will be rejected
+    if (!receiveMessageQueueInterruptEnabled || OEM0Enabled || OEM1Enabled ||
+        OEM2Enabled || reserved)
     {
         return ipmi::responseInvalidFieldRequest();
     }
 
+    phosphor::host::event::Buffer& buffer = ipmid_get_host_event_buffer();
+    buffer.setEnabled(eventMessageBufferEnabled);
+    buffer.setFullInterruptEnabled(eventMessageBufferFullInterruptEnabled);
+    buffer.setSystemEventLogging(systemEventLogEnable);
+
     return ipmi::responseSuccess();
 }
 
@@ -0,0 +1,92 @@
+#include "dbus-sdr/entityassociations.hpp"
+
+#include "gtest/gtest.h"
+
+using dynamic_sensors::ipmi::entity::EntityAssociations;
+using dynamic_sensors::ipmi::entity::InterfaceMap;
+
+static constexpr const char* board =
+    "/xyz/openbmc_project/inventory/system/board/Main_Board";
+static constexpr const char* sensor =
+    "/xyz/openbmc_project/inventory/system/board/Main_Board/Fan_1";
+static constexpr const char* ipmiDecorator =
+    "xyz.openbmc_project.Inventory.Decorator.Ipmi";
+
+static InterfaceMap entity(const char* interface, uint64_t id,
+                           uint64_t instance)
+{
+    return {{interface,
+             {{"EntityId", id},
+              {"EntityInstance", instance},
+              {"Name", std::string("Fan")},
+              {"PwmThresholds", std::vector<double>{0.5, 0.75}}}}};
+}
+
+TEST(EntityAssociations, BoardEntity)
+{
+    EntityAssociations associations;
+    associations.addInterfaces(board, entity(ipmiDecorator, 7, 2));
+
+    uint8_t entityId = 0;
+    uint8_t entityInstance = 1;
+    associations.lookup(board, "Fan_1", entityId, entityInstance);
+    EXPECT_EQ(entityId, 7);
+    EXPECT_EQ(entityInstance, 2);
+
+    // Nothing for other boards
+    entityId = 0;
+    entityInstance = 1;
+    associations.lookup("/other", "Fan_1", entityId, entityInstance);
+    EXPECT_EQ(entityId, 0);
+    EXPECT_EQ(entityInstance, 1);
+}
+
+TEST(EntityAssociations, SensorConfigurationOverridesBoard)
+{
+    EntityAssociations associations;
+    associations.addInterfaces(board, entity(ipmiDecorator, 7, 2));
+
+    // The fan configuration wins over the others of a fan
+    InterfaceMap interfaces =
+        entity("xyz.openbmc_project.Configuration.AspeedFan", 29, 3);
+    interfaces.merge(
+        entity("xyz.openbmc_project.Configuration.AspeedFan.Connector", 1, 1));
+    interfaces.emplace("xyz.openbmc_project.Inventory.Item",
+                       dynamic_sensors::ipmi::entity::PropertyMap{});
+    associations.addInterfaces(sensor, interfaces);
+    EXPECT_EQ(associations.size(), 2);
+
+    uint8_t entityId = 0;
+    uint8_t entityInstance = 1;
+    associations.lookup(board, "Fan_1", entityId, entityInstance);
+    EXPECT_EQ(entityId, 29);
+    EXPECT_EQ(entityInstance, 3);
+}
+
+TEST(EntityAssociations, FollowsSignals)
+{
+    EntityAssociations associations;
+    associations.addInterfaces(board, entity(ipmiDecorator, 7, 2));
+    associations.updateProperties(board, ipmiDecorator,
+                                  {{"EntityInstance", uint64_t(4)}});
+
+    uint8_t entityId = 0;
+    uint8_t entityInstance = 1;
+    associations.lookup(board, "Fan_1", entityId, entityInstance);
+    EXPECT_EQ(entityId, 7);
+    EXPECT_EQ(entityInstance, 4);
+
+    // A property of the wrong type is left out
+    associations.updateProperties(board, ipmiDecorator,
+                                  {{"EntityId", std::string("7")}});
+    associations.lookup(board, "Fan_1", entityId, entityInstance);
+    EXPECT_EQ(entityId, 7);
+
+    associations.removeInterfaces(board, {ipmiDecorator});
+    EXPECT_EQ(associations.size(), 0);
+    entityId = 0;
+    entityInstance = 1;
+    associations.lookup(board, "Fan_1", entityId, entityInstance);
+    EXPECT_EQ(entityId, 0);
+    EXPECT_EQ(entityInstance, 1);
+}
@@ -0,0 +1,109 @@
+#include "dbus-sdr/frucache.hpp"
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using dynamic_sensors::ipmi::fru::FruCache;
+using dynamic_sensors::ipmi::fru::FruImage;
+
+static std::vector<uint8_t> image(uint8_t fill)
+{
+    return std::vector<uint8_t>(8, fill);
+}
+
+TEST(FruCache, FindAndReplace)
+{
+    FruCache cache(4);
+    EXPECT_EQ(cache.find(1), nullptr);
+
+    FruImage& added = cache.insert(1, 3, 0x50, image(1));
+    EXPECT_EQ(added.devId, 1);
+    EXPECT_EQ(added.bus, 3);
+    EXPECT_EQ(added.addr, 0x50);
+    EXPECT_FALSE(added.dirty);
+
+    ASSERT_NE(cache.find(1), nullptr);
+    EXPECT_EQ(*cache.find(1)->data, image(1));
+
+    cache.insert(1, 3, 0x50, image(2));
+    EXPECT_EQ(cache.size(), 1);
+    EXPECT_EQ(*cache.find(1)->data, image(2));
+
+    cache.erase(1);
+    EXPECT_EQ(cache.find(1), nullptr);
+    EXPECT_EQ(cache.size(), 0);
+}
+
+TEST(FruCache, EvictsLeastRecentlyUsed)
+{
+    FruCache cache(3);
+    cache.insert(1, 0, 1, image(1));
+    cache.insert(2, 0, 2, image(2));
+    cache.insert(3, 0, 3, image(3));
+
+    // Device 1 is used again, so device 2 is the oldest
+    EXPECT_NE(cache.find(1), nullptr);
+    // Peeking doesn't count as a use
+    EXPECT_NE(cache.peek(2), nullptr);
+    cache.insert(4, 0, 4, image(4));
+
+    EXPECT_EQ(cache.size(), 3);
+    EXPECT_EQ(cache.peek(2), nullptr);
+    EXPECT_NE(cache.peek(1), nullptr);
+    EXPECT_NE(cache.peek(3), nullptr);
+    EXPECT_NE(cache.peek(4), nullptr);
+}
+
+TEST(FruCache, KeepsDirtyImages)
+{
+    FruCache cache(2);
+    cache.insert(1, 0, 1, image(1)).dirty = true;
+    cache.insert(2, 0, 2, image(2));
+    cache.insert(3, 0, 3, image(3));
+
+    // Device 1 is the oldest but not written back yet
+    EXPECT_NE(cache.peek(1), nullptr);
+    EXPECT_EQ(cache.peek(2), nullptr);
+    EXPECT_NE(cache.peek(3), nullptr);
+
+    cache.peek(1)->dirty = false;
+    cache.insert(4, 0, 4, image(4));
+    EXPECT_EQ(cache.peek(1), nullptr);
+    EXPECT_EQ(cache.size(), 2);
+}
+
+TEST(FruCache, EraseDevice)
+{
+    FruCache cache;
+    cache.insert(1, 5, 0x50, image(1));
+    cache.insert(2, 5, 0x51, image(2));
+    cache.insert(3, 5, 0x50, image(3));
+
+    cache.eraseDevice(5, 0x50);
+    EXPECT_EQ(cache.peek(1), nullptr);
+    EXPECT_EQ(cache.peek(3), nullptr);
+    EXPECT_NE(cache.peek(2), nullptr);
+
+    cache.clear();
+    EXPECT_EQ(cache.size(), 0);
+    EXPECT_EQ(cache.peek(2), nullptr);
+}
+
+TEST(FruCache, WritableCopiesShared)
+{
+    FruCache cache;
+    FruImage& added = cache.insert(1, 0, 1, image(1));
+
+    // Nothing else holds the data, so it changes in place
+    const std::vector<uint8_t>* before = added.data.get();
+    added.writable()[0] = 2;
+    EXPECT_EQ(added.data.get(), before);
+
+    // A response reading the data keeps what it read
+    std::shared_ptr<const std::vector<uint8_t>> read = added.data;
+    added.writable()[0] = 3;
+    EXPECT_NE(added.data.get(), read.get());
+    EXPECT_EQ((*read)[0], 2);
+    EXPECT_EQ((*added.data)[0], 3);
+}
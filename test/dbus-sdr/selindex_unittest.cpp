@@ -0,0 +1,223 @@
+#include "dbus-sdr/selindex.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using dynamic_sensors::ipmi::sel::parseSELLine;
+using dynamic_sensors::ipmi::sel::SELIndex;
+using dynamic_sensors::ipmi::sel::SELIndexEntry;
+
+static std::string selLine(int recordID)
+{
+    return "2020-06-15T10:20:30.123456+00:00 " + std::to_string(recordID) +
+           ",2,010203,20,/xyz/openbmc_project/sensors/temperature/CPU0,1";
+}
+
+class SELIndexTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        char dirTemplate[] = "/tmp/selindex_XXXXXX";
+        ASSERT_NE(mkdtemp(dirTemplate), nullptr);
+        dir = dirTemplate;
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(dir);
+    }
+
+    void append(const std::string& file, int first, int last)
+    {
+        std::ofstream out(dir / file, std::ios::app);
+        for (int id = first; id <= last; id++)
+        {
+            out << selLine(id) << '\n';
+        }
+    }
+
+    std::string readBack(const SELIndex& index, uint16_t recordID)
+    {
+        std::string line;
+        const SELIndexEntry* entry = index.find(recordID);
+        if (entry == nullptr || !index.read(*entry, line))
+        {
+            return "";
+        }
+        return line;
+    }
+
+    std::filesystem::path dir;
+};
+
+TEST(ParseSELLine, Fields)
+{
+    uint16_t recordID = 0;
+    uint32_t timestamp = 0;
+    ASSERT_TRUE(parseSELLine(selLine(42), recordID, timestamp));
+    EXPECT_EQ(recordID, 42);
+    EXPECT_NE(timestamp, dynamic_sensors::ipmi::sel::invalidSELTimestamp);
+
+    ASSERT_TRUE(parseSELLine("garbage 7,2,00", recordID, timestamp));
+    EXPECT_EQ(recordID, 7);
+    EXPECT_EQ(timestamp, dynamic_sensors::ipmi::sel::invalidSELTimestamp);
+
+    EXPECT_FALSE(parseSELLine("", recordID, timestamp));
+    EXPECT_FALSE(parseSELLine("2020-06-15T10:20:30", recordID, timestamp));
+    EXPECT_FALSE(parseSELLine("2020-06-15T10:20:30 x,2", recordID, timestamp));
+    EXPECT_FALSE(parseSELLine("2020-06-15T10:20:30 12", recordID, timestamp));
+    EXPECT_FALSE(
+        parseSELLine("2020-06-15T10:20:30 70000,2", recordID, timestamp));
+}
+
+TEST_F(SELIndexTest, BuildAcrossRotatedFiles)
+{
+    append("ipmi_sel.2", 1, 10);
+    append("ipmi_sel.1", 11, 20);
+    append("ipmi_sel", 21, 25);
+    append("other_log", 100, 110);
+
+    SELIndex index(dir, "ipmi_sel");
+    index.refresh();
+
+    ASSERT_EQ(index.size(), 25);
+    EXPECT_EQ(index.files().size(), 3);
+    EXPECT_EQ(index.first()->recordID, 1);
+    EXPECT_EQ(index.last()->recordID, 25);
+    EXPECT_EQ(readBack(index, 1), selLine(1));
+    EXPECT_EQ(readBack(index, 15), selLine(15));
+    EXPECT_EQ(readBack(index, 25), selLine(25));
+    EXPECT_EQ(index.find(100), nullptr);
+
+    ASSERT_NE(index.next(10), nullptr);
+    EXPECT_EQ(index.next(10)->recordID, 11);
+    EXPECT_EQ(index.next(25), nullptr);
+}
+
+TEST_F(SELIndexTest, NewestDuplicateWins)
+{
+    std::ofstream(dir / "ipmi_sel.1") << "2020-01-01T00:00:00 5,2,AA\n";
+    std::ofstream(dir / "ipmi_sel") << "2020-01-02T00:00:00 5,2,BB\n";
+
+    SELIndex index(dir, "ipmi_sel");
+    index.refresh();
+
+    ASSERT_EQ(index.size(), 1);
+    EXPECT_EQ(readBack(index, 5), "2020-01-02T00:00:00 5,2,BB");
+}
+
+TEST_F(SELIndexTest, FollowsAppends)
+{
+    append("ipmi_sel", 1, 5);
+    SELIndex index(dir, "ipmi_sel");
+    index.refresh();
+    ASSERT_EQ(index.size(), 5);
+    uint64_t generation = index.generation();
+    index.refresh();
+    EXPECT_EQ(index.generation(), generation);
+
+    append("ipmi_sel", 6, 8);
+    // A line still being written is picked up once it is complete
+    std::ofstream(dir / "ipmi_sel", std::ios::app) << "2020-01-01T00:00:00 9";
+    index.refresh();
+    EXPECT_EQ(index.size(), 8);
+    EXPECT_NE(index.generation(), generation);
+    EXPECT_EQ(readBack(index, 8), selLine(8));
+
+    std::ofstream(dir / "ipmi_sel", std::ios::app) << ",2,CC\n";
+    index.refresh();
+    EXPECT_EQ(index.size(), 9);
+    EXPECT_EQ(readBack(index, 9), "2020-01-01T00:00:00 9,2,CC");
+    EXPECT_EQ(index.next(8)->recordID, 9);
+}
+
+TEST_F(SELIndexTest, ReportsAppends)
+{
+    append("ipmi_sel", 1, 5);
+    SELIndex index(dir, "ipmi_sel");
+    std::vector<uint16_t> appended;
+    index.onAppend([&appended, &index](const SELIndexEntry& entry) {
+        // Already indexed
+        EXPECT_NE(index.find(entry.recordID), nullptr);
+        appended.push_back(entry.recordID);
+    });
+    index.refresh();
+    EXPECT_TRUE(appended.empty());
+
+    append("ipmi_sel", 6, 7);
+    index.refresh();
+    index.refresh();
+    EXPECT_EQ(appended, std::vector<uint16_t>({6, 7}));
+
+    // Rebuilt after the rotation, nothing reported
+    std::filesystem::rename(dir / "ipmi_sel", dir / "ipmi_sel.1");
+    append("ipmi_sel", 8, 8);
+    index.refresh();
+    EXPECT_EQ(index.size(), 8);
+    EXPECT_EQ(appended.size(), 2);
+}
+
+TEST_F(SELIndexTest, FollowsRotationAndClear)
+{
+    append("ipmi_sel", 1, 5);
+    SELIndex index(dir, "ipmi_sel");
+    index.refresh();
+
+    std::filesystem::rename(dir / "ipmi_sel", dir / "ipmi_sel.1");
+    append("ipmi_sel", 6, 7);
+    index.refresh();
+    EXPECT_EQ(index.size(), 7);
+    EXPECT_EQ(readBack(index, 3), selLine(3));
+    EXPECT_EQ(readBack(index, 7), selLine(7));
+
+    std::filesystem::remove(dir / "ipmi_sel.1");
+    std::filesystem::remove(dir / "ipmi_sel");
+    index.refresh();
+    EXPECT_TRUE(index.empty());
+    EXPECT_TRUE(index.files().empty());
+    EXPECT_EQ(index.first(), nullptr);
+
+    append("ipmi_sel", 1, 1);
+    index.refresh();
+    EXPECT_EQ(index.size(), 1);
+    EXPECT_EQ(readBack(index, 1), selLine(1));
+}
+
+TEST_F(SELIndexTest, MissingDirectory)
+{
+    SELIndex index(dir / "missing", "ipmi_sel");
+    index.refresh();
+    EXPECT_TRUE(index.empty());
+}
+
+TEST_F(SELIndexTest, EndsFollowTheFilesAfterWrap)
+{
+    // The IDs wrapped around while ipmi_sel.1 was live
+    append("ipmi_sel.1", 65530, 65535);
+    append("ipmi_sel.1", 1, 3);
+    append("ipmi_sel", 4, 6);
+
+    SELIndex index(dir, "ipmi_sel");
+    index.refresh();
+    ASSERT_NE(index.first(), nullptr);
+    EXPECT_EQ(index.first()->recordID, 65530);
+    EXPECT_EQ(index.last()->recordID, 6);
+    EXPECT_EQ(index.highest()->recordID, 65535);
+
+    append("ipmi_sel", 7, 7);
+    index.refresh();
+    EXPECT_EQ(index.first()->recordID, 65530);
+    EXPECT_EQ(index.last()->recordID, 7);
+
+    // The oldest ID logged again, the next line is the oldest indexed
+    append("ipmi_sel", 65530, 65530);
+    index.refresh();
+    EXPECT_EQ(index.first()->recordID, 65531);
+    EXPECT_EQ(index.last()->recordID, 65530);
+}
@@ -0,0 +1,187 @@
+#include "dbus-sdr/seljournal.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+
+#include "gtest/gtest.h"
+
+using dynamic_sensors::ipmi::sel::SELJournal;
+using dynamic_sensors::ipmi::sel::SELRecord;
+using dynamic_sensors::ipmi::sel::selRecordContentSize;
+
+static std::array<uint8_t, selRecordContentSize> content(uint8_t fill)
+{
+    std::array<uint8_t, selRecordContentSize> data;
+    data.fill(fill);
+    return data;
+}
+
+class SELJournalTest : public testing::Test
+{
+  protected:
+    void SetUp() override
+    {
+        char dirTemplate[] = "/tmp/seljournal_XXXXXX";
+        ASSERT_NE(mkdtemp(dirTemplate), nullptr);
+        dir = dirTemplate;
+        path = dir / "sel_journal";
+    }
+
+    void TearDown() override
+    {
+        std::filesystem::remove_all(dir);
+    }
+
+    std::filesystem::path dir;
+    std::filesystem::path path;
+};
+
+TEST(SystemEventContent, WireLayout)
+{
+    auto data = dynamic_sensors::ipmi::sel::systemEventContent(
+        0x11223344, 0x0020, 0x04, 0x01, 0x42, 0x81, {0xA0, 0xB1, 0xC2});
+    std::array<uint8_t, selRecordContentSize> expected = {
+        0x44, 0x33, 0x22, 0x11, 0x20, 0x00, 0x04,
+        0x01, 0x42, 0x81, 0xA0, 0xB1, 0xC2};
+    EXPECT_EQ(data, expected);
+}
+
+TEST_F(SELJournalTest, AppendAndFind)
+{
+    SELJournal journal(path, 8);
+    EXPECT_TRUE(journal.created());
+    EXPECT_EQ(journal.size(), 0);
+    EXPECT_EQ(journal.first(), nullptr);
+    EXPECT_EQ(journal.find(1), nullptr);
+
+    EXPECT_EQ(journal.append(0x02, content(1), 100), 1);
+    EXPECT_EQ(journal.append(0x02, content(2), 200), 2);
+    EXPECT_EQ(journal.append(0xE0, content(3), 300), 3);
+
+    EXPECT_EQ(journal.size(), 3);
+    EXPECT_EQ(journal.addTimestamp(), 300);
+    ASSERT_NE(journal.find(2), nullptr);
+    EXPECT_EQ(journal.find(2)->content, content(2));
+    EXPECT_EQ(journal.find(3)->recordType, 0xE0);
+    EXPECT_EQ(journal.find(4), nullptr);
+    EXPECT_EQ(journal.find(0), nullptr);
+    EXPECT_EQ(journal.find(0xFFFF), nullptr);
+
+    EXPECT_EQ(journal.first()->recordID, 1);
+    EXPECT_EQ(journal.last()->recordID, 3);
+    EXPECT_EQ(journal.next(1)->recordID, 2);
+    EXPECT_EQ(journal.next(3), nullptr);
+    EXPECT_FALSE(journal.overflow());
+}
+
+TEST_F(SELJournalTest, Persists)
+{
+    {
+        SELJournal journal(path, 8);
+        journal.append(0x02, content(7), 100);
+        journal.erase(50);
+        journal.append(0x02, content(8), 200);
+    }
+
+    SELJournal journal(path, 8);
+    EXPECT_FALSE(journal.created());
+    EXPECT_EQ(journal.size(), 1);
+    EXPECT_EQ(journal.eraseTimestamp(), 50);
+    ASSERT_NE(journal.find(2), nullptr);
+    EXPECT_EQ(journal.find(2)->content, content(8));
+    EXPECT_EQ(journal.append(0x02, content(9), 300), 3);
+}
+
+TEST_F(SELJournalTest, TextRecordIDPersistsUntilErase)
+{
+    {
+        SELJournal journal(path, 8);
+        EXPECT_EQ(journal.textRecordID(), 0);
+        journal.append(0x02, content(1), 100);
+        journal.setTextRecordID(42);
+    }
+
+    SELJournal journal(path, 8);
+    EXPECT_FALSE(journal.created());
+    EXPECT_EQ(journal.textRecordID(), 42);
+    journal.erase(200);
+    EXPECT_EQ(journal.textRecordID(), 0);
+}
+
+TEST_F(SELJournalTest, OverwritesOldestWhenFull)
+{
+    SELJournal journal(path, 4);
+    for (uint8_t n = 1; n <= 6; n++)
+    {
+        journal.append(0x02, content(n), n);
+    }
+
+    EXPECT_EQ(journal.size(), 4);
+    EXPECT_TRUE(journal.overflow());
+    EXPECT_EQ(journal.find(2), nullptr);
+    EXPECT_EQ(journal.first()->recordID, 3);
+    EXPECT_EQ(journal.last()->recordID, 6);
+    EXPECT_EQ(journal.find(5)->content, content(5));
+    EXPECT_EQ(journal.next(4)->recordID, 5);
+
+    journal.erase(10);
+    EXPECT_EQ(journal.size(), 0);
+    EXPECT_FALSE(journal.overflow());
+    EXPECT_EQ(journal.append(0x02, content(7), 11), 7);
+    EXPECT_EQ(journal.first()->recordID, 7);
+}
+
+TEST_F(SELJournalTest, RecordIDsWrap)
+{
+    SELJournal journal(path, 4);
+    // Walk the record IDs up to just below the end of the range
+    for (uint32_t n = 1; n < 0xFFFD; n++)
+    {
+        journal.append(0x02, content(0), 0);
+    }
+    EXPECT_EQ(journal.append(0x02, content(1), 0), 0xFFFD);
+    EXPECT_EQ(journal.append(0x02, content(2), 0), 0xFFFE);
+    EXPECT_EQ(journal.append(0x02, content(3), 0), 1);
+
+    EXPECT_EQ(journal.first()->recordID, 0xFFFC);
+    EXPECT_EQ(journal.next(0xFFFE)->recordID, 1);
+    EXPECT_EQ(journal.find(1)->content, content(3));
+    EXPECT_EQ(journal.find(0xFFFD)->content, content(1));
+    EXPECT_EQ(journal.find(2), nullptr);
+}
+
+TEST_F(SELJournalTest, RecreatedForOtherCapacity)
+{
+    {
+        SELJournal journal(path, 8);
+        journal.append(0x02, content(1), 100);
+    }
+    SELJournal journal(path, 16);
+    EXPECT_TRUE(journal.created());
+    EXPECT_EQ(journal.size(), 0);
+}
+
+TEST_F(SELJournalTest, RecreatedWhenCorrupt)
+{
+    {
+        SELJournal journal(path, 8);
+        journal.append(0x02, content(1), 100);
+    }
+    {
+        std::fstream file(path, std::ios::in | std::ios::out);
+        file.write("junk", 4);
+    }
+    SELJournal journal(path, 8);
+    EXPECT_TRUE(journal.created());
+    EXPECT_EQ(journal.size(), 0);
+}
+
+TEST_F(SELJournalTest, InvalidCapacity)
+{
+    EXPECT_THROW(SELJournal(path, 0), std::invalid_argument);
+    EXPECT_THROW(SELJournal(path, 0xFFFE), std::invalid_argument);
+    EXPECT_THROW(SELJournal(dir / "missing" / "journal", 8),
+                 std::system_error);
+}
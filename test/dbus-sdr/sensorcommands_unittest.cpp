@@ -1,6 +1,7 @@
 #include "dbus-sdr/sensorutils.hpp"
 
 #include <cmath>
+#include <vector>
 
 #include "gtest/gtest.h"
 
@@ -486,3 +487,36 @@ TEST(sensorUtils, TestRanges)
     // because they are tested through actual use, relating "x" to "y".
     testRanges();
 }
+
+TEST(sensorUtils, AttributesCache)
+{
+    ipmi::SensorAttributesCache cache;
+
+    const ipmi::SensorAttributes* attributes = cache.get(277, 0);
+    ASSERT_NE(attributes, nullptr);
+
+    int16_t mValue;
+    int8_t rExp;
+    int16_t bValue;
+    int8_t bExp;
+    bool bSigned;
+    ASSERT_TRUE(ipmi::getSensorAttributes(277, 0, mValue, rExp, bValue, bExp,
+                                          bSigned));
+    EXPECT_EQ(attributes->mValue, mValue);
+    EXPECT_EQ(attributes->rExp, rExp);
+    EXPECT_EQ(attributes->bValue, bValue);
+    EXPECT_EQ(attributes->bExp, bExp);
+    EXPECT_EQ(attributes->bSigned, bSigned);
+
+    // Same range hands back the same solution
+    EXPECT_EQ(cache.get(277, 0), attributes);
+
+    // A new range is solved again, an unusable one is reported every time
+    attributes = cache.get(127, -128);
+    ASSERT_NE(attributes, nullptr);
+    EXPECT_EQ(attributes->bSigned, true);
+    EXPECT_EQ(cache.get(0, 0), nullptr);
+    EXPECT_EQ(cache.get(0, 0), nullptr);
+    EXPECT_EQ(cache.get(NAN, 0), nullptr);
+    EXPECT_NE(cache.get(127, -128), nullptr);
+}
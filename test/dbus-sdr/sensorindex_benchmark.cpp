@@ -0,0 +1,100 @@
+#include "dbus-sdr/sensorindex.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <boost/bimap.hpp>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Both directions of the sensor number index, compared with the
+// boost::bimap<int, std::string> it replaced. Run by 'make benchmarks', the
+// lookups themselves are checked by sensorindex_unittest.
+
+static constexpr size_t benchSensors = 300;
+
+struct SensorIndexBench
+{
+    SensorIndexBench()
+    {
+        index.reserve(benchSensors);
+        for (size_t n = 0; n < benchSensors; n++)
+        {
+            paths.emplace_back("/xyz/openbmc_project/sensors/voltage/PSU" +
+                               std::to_string(n % 4) + "_Input_Voltage_" +
+                               std::to_string(n));
+            const auto& entry = index.append(paths.back(), "service", {});
+            numbers.push_back(entry.sensorNumber);
+            bimap.insert(boost::bimap<int, std::string>::value_type(
+                entry.sensorNumber, paths.back()));
+        }
+    }
+
+    std::vector<std::string> paths;
+    std::vector<uint16_t> numbers;
+    SensorIndex index;
+    boost::bimap<int, std::string> bimap;
+};
+
+static const SensorIndexBench& bench()
+{
+    static const SensorIndexBench instance;
+    return instance;
+}
+
+static void NumberToPathBimap(benchmark::State& state)
+{
+    const SensorIndexBench& b = bench();
+    for (auto _ : state)
+    {
+        for (uint16_t number : b.numbers)
+        {
+            benchmark::DoNotOptimize(b.bimap.left.at(number).size());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * benchSensors);
+}
+BENCHMARK(NumberToPathBimap);
+
+static void NumberToPathIndex(benchmark::State& state)
+{
+    const SensorIndexBench& b = bench();
+    for (auto _ : state)
+    {
+        for (uint16_t number : b.numbers)
+        {
+            benchmark::DoNotOptimize(b.index.find(number)->path.size());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * benchSensors);
+}
+BENCHMARK(NumberToPathIndex);
+
+static void PathToNumberBimap(benchmark::State& state)
+{
+    const SensorIndexBench& b = bench();
+    for (auto _ : state)
+    {
+        for (const auto& path : b.paths)
+        {
+            benchmark::DoNotOptimize(b.bimap.right.at(path));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * benchSensors);
+}
+BENCHMARK(PathToNumberBimap);
+
+static void PathToNumberIndex(benchmark::State& state)
+{
+    const SensorIndexBench& b = bench();
+    for (auto _ : state)
+    {
+        for (const auto& path : b.paths)
+        {
+            benchmark::DoNotOptimize(
+                b.index.find(std::string_view(path))->sensorNumber);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * benchSensors);
+}
+BENCHMARK(PathToNumberIndex);
@@ -0,0 +1,131 @@
+#include "dbus-sdr/sensorindex.hpp"
+
+#include "dbus-sdr/sensortypes.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include "gtest/gtest.h"
+
+static std::string sensorPath(size_t n)
+{
+    return "/xyz/openbmc_project/sensors/temperature/Sensor_" +
+           std::to_string(n);
+}
+
+TEST(SensorIndex, EmptyIndex)
+{
+    SensorIndex index;
+
+    EXPECT_TRUE(index.empty());
+    EXPECT_EQ(index.find(static_cast<uint16_t>(0)), nullptr);
+    EXPECT_EQ(index.find(std::string_view(sensorPath(0))), nullptr);
+    EXPECT_EQ(index.record(0), nullptr);
+}
+
+TEST(SensorIndex, BothDirections)
+{
+    SensorIndex index;
+    index.reserve(2);
+    index.append(sensorPath(0), "xyz.openbmc_project.HwmonTempSensor",
+                 {"xyz.openbmc_project.Sensor.Value"});
+    index.append(sensorPath(1), "xyz.openbmc_project.CPUSensor",
+                 {"xyz.openbmc_project.Sensor.Value",
+                  "xyz.openbmc_project.Sensor.Threshold.Warning"});
+
+    const SensorIndexEntry* entry = index.find(static_cast<uint16_t>(1));
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->path, sensorPath(1));
+    EXPECT_EQ(entry->service, "xyz.openbmc_project.CPUSensor");
+    EXPECT_EQ(entry->interfaces.size(), 2);
+    EXPECT_EQ(entry->recordID, 1);
+
+    entry = index.find(std::string_view(sensorPath(0)));
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->sensorNumber, 0);
+    EXPECT_EQ(entry, index.record(0));
+}
+
+TEST(SensorIndex, NumbersSkipReservedAndLun2)
+{
+    SensorIndex index;
+    for (size_t n = 0; n < maxIPMISensors; n++)
+    {
+        index.append(sensorPath(n), "service", {});
+    }
+
+    EXPECT_EQ(index.record(254)->sensorNumber, 0x0FE);
+    EXPECT_EQ(index.record(255)->sensorNumber, 0x100);
+    EXPECT_EQ(index.record(509)->sensorNumber, 0x1FE);
+    EXPECT_EQ(index.record(510)->sensorNumber, 0x300);
+    EXPECT_EQ(index.record(764)->sensorNumber, 0x3FE);
+
+    EXPECT_EQ(index.find(static_cast<uint16_t>(0x0FF)), nullptr);
+    EXPECT_EQ(index.find(static_cast<uint16_t>(0x200)), nullptr);
+    EXPECT_EQ(index.find(static_cast<uint16_t>(0x400)), nullptr);
+    EXPECT_EQ(index.find(static_cast<uint16_t>(0x300))->path,
+              sensorPath(510));
+
+    EXPECT_THROW(index.append(sensorPath(765), "service", {}),
+                 std::out_of_range);
+}
+
+TEST(SensorIndex, PathLookupSurvivesGrowth)
+{
+    // Without a reserve() the entries move as they grow, the path hash
+    // must keep pointing at valid strings.
+    SensorIndex index;
+    for (size_t n = 0; n < 100; n++)
+    {
+        index.append(sensorPath(n), "service", {});
+    }
+
+    for (size_t n = 0; n < 100; n++)
+    {
+        const SensorIndexEntry* entry =
+            index.find(std::string_view(sensorPath(n)));
+        ASSERT_NE(entry, nullptr);
+        EXPECT_EQ(entry->recordID, n);
+    }
+}
+
+TEST(SensorIndex, ClassifiesOnAppend)
+{
+    SensorIndex index;
+    const SensorIndexEntry& fan = index.append(
+        "/xyz/openbmc_project/sensors/fan_tach/Fan_1_Input_Speed_Rear",
+        "service", {});
+    EXPECT_EQ(fan.typeString, "fan_tach");
+    EXPECT_EQ(fan.sensorType, static_cast<uint8_t>(SensorTypeCodes::fan));
+    EXPECT_EQ(fan.eventType,
+              static_cast<uint8_t>(SensorEventTypeCodes::threshold));
+    // Shortened to fit the SDR
+    EXPECT_EQ(fan.sdrId, "Fan 1 In Speed R");
+    EXPECT_EQ(fan.staticSensor, noStaticSensor);
+
+    const SensorIndexEntry& vr = index.append(
+        "/xyz/openbmc_project/vr/profile/VR_1", "service", {});
+    EXPECT_EQ(vr.typeString, "profile");
+    EXPECT_EQ(vr.sensorType, 0);
+    EXPECT_EQ(vr.eventType, 0);
+    EXPECT_EQ(vr.sdrId, "VR 1");
+}
+
+TEST(SensorIndex, ClassificationMatchesPath)
+{
+    static constexpr const char* types[] = {
+        "temperature", "voltage", "current", "fan_tach", "fan_pwm", "power",
+        "memory",      "state",   "buttons", "watchdog", "unknown"};
+
+    SensorIndex index;
+    for (const char* type : types)
+    {
+        std::string path = "/xyz/openbmc_project/sensors/" +
+                           std::string(type) + "/CPU0_Input_Sensor_1";
+        const SensorIndexEntry& entry = index.append(path, "service", {});
+        EXPECT_EQ(entry.typeString, getSensorTypeStringFromPath(path));
+        EXPECT_EQ(entry.sensorType, getSensorTypeFromPath(path));
+        EXPECT_EQ(entry.eventType, getSensorEventTypeFromPath(path));
+        EXPECT_EQ(entry.sdrId, ipmi::sensor::parseSdrIdFromPath(path));
+    }
+}
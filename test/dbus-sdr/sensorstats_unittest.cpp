@@ -0,0 +1,94 @@
+#include "dbus-sdr/sensorstats.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <string>
+
+#include "gtest/gtest.h"
+
+using namespace std::chrono_literals;
+
+static const std::string cpuTemp =
+    "/xyz/openbmc_project/sensors/temperature/CPU0_Temp";
+static const std::string fan0 = "/xyz/openbmc_project/sensors/fan_tach/Fan_0";
+
+TEST(StatsHistogram, Percentiles)
+{
+    details::StatsHistogram histogram;
+    EXPECT_EQ(histogram.percentile(50), 0);
+
+    // 90 fast samples and 10 slow ones
+    for (int i = 0; i < 90; i++)
+    {
+        histogram.record(100);
+    }
+    for (int i = 0; i < 10; i++)
+    {
+        histogram.record(5000);
+    }
+
+    EXPECT_EQ(histogram.count(), 100);
+    EXPECT_EQ(histogram.percentile(50), 128);
+    EXPECT_EQ(histogram.percentile(90), 128);
+    EXPECT_EQ(histogram.percentile(99), 8192);
+    EXPECT_EQ(histogram.percentile(100), 8192);
+}
+
+TEST(StatsHistogram, Overflow)
+{
+    details::StatsHistogram histogram;
+    histogram.record(0);
+    histogram.record(UINT64_MAX);
+
+    EXPECT_EQ(histogram.percentile(50), 1);
+    EXPECT_EQ(histogram.percentile(100),
+              1ULL << (details::StatsHistogram::bucketCount - 1));
+}
+
+TEST(IPMIStatsTable, Readings)
+{
+    details::IPMIStatsTable table;
+    EXPECT_EQ(table.enabled(), details::enableInstrumentation);
+
+    EXPECT_TRUE(table.updateReading(cpuTemp, 40.0, 40));
+    EXPECT_FALSE(table.updateReading(cpuTemp, 45.0, 45));
+    EXPECT_FALSE(table.updateReading(cpuTemp, NAN, 0));
+    EXPECT_FALSE(table.updateReading(cpuTemp, 35.0, 35));
+    table.updateTiming(cpuTemp, 300us, 2500ms);
+
+    ASSERT_EQ(table.getEntries().size(), 1);
+    const details::IPMIStatsEntry& entry = table.getEntries()[0];
+    EXPECT_EQ(entry.getName(), "CPU0_Temp");
+    EXPECT_EQ(entry.getReadings(), 3);
+    EXPECT_EQ(entry.getMissings(), 1);
+    EXPECT_EQ(entry.getStreakRead(), 1);
+    EXPECT_EQ(entry.getMin(), 35.0);
+    EXPECT_EQ(entry.getMax(), 45.0);
+    EXPECT_EQ(entry.getReadLatency().percentile(50), 512);
+    EXPECT_EQ(entry.getCacheAge().percentile(50), 4096);
+}
+
+TEST(IPMIStatsTable, WipeKeepsStatsByPath)
+{
+    details::IPMIStatsTable table;
+    table.updateName(cpuTemp, 0x01, "CPU0 Temp");
+    table.updateName(fan0, 0x02, "Fan 0");
+    table.updateReading(fan0, 4000.0, 40);
+
+    // The SDR is rebuilt with the fan now numbered before the CPU
+    table.wipeTable();
+    EXPECT_EQ(table.getEntries()[1].getSensorNumber(), invalidSensorNumber);
+    table.updateName(fan0, 0x01, "Fan 0");
+    table.updateName(cpuTemp, 0x02, "CPU0 Temp");
+    table.updateReading(fan0, 4100.0, 41);
+
+    ASSERT_EQ(table.getEntries().size(), 2);
+    const details::IPMIStatsEntry& entry = table.getEntries()[1];
+    EXPECT_EQ(entry.getPath(), fan0);
+    EXPECT_EQ(entry.getSensorNumber(), 0x01);
+    EXPECT_EQ(entry.getReadings(), 2);
+    EXPECT_EQ(table.getName(cpuTemp), "CPU0 Temp");
+
+    table.clear();
+    EXPECT_TRUE(table.getEntries().empty());
+}
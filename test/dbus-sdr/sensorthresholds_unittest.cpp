@@ -0,0 +1,81 @@
+#include "dbus-sdr/sensorthresholds.hpp"
+
+#include "gtest/gtest.h"
+
+using ipmi::SensorThresholdState;
+using ipmi::ThresholdLevel;
+
+TEST(SensorThresholdState, PropertyNames)
+{
+    EXPECT_EQ(ipmi::getThresholdLevel("CriticalLow"),
+              ThresholdLevel::criticalLow);
+    EXPECT_EQ(ipmi::getAlarmLevel("WarningAlarmHigh"),
+              ThresholdLevel::warningHigh);
+    EXPECT_FALSE(ipmi::getThresholdLevel("WarningAlarmHigh"));
+    EXPECT_FALSE(ipmi::getAlarmLevel("WarningHigh"));
+    EXPECT_FALSE(ipmi::getAlarmLevel("Value"));
+
+    SensorThresholdState state;
+    EXPECT_TRUE(state.updateThreshold("WarningHigh", 80.0));
+    EXPECT_FALSE(state.updateThreshold("MaxValue", 127.0));
+    EXPECT_TRUE(state.updateAlarm("CriticalAlarmLow", true, false));
+    EXPECT_FALSE(state.updateAlarm("Functional", true, false));
+
+    EXPECT_EQ(state.threshold(ThresholdLevel::warningHigh), 80.0);
+    EXPECT_FALSE(state.threshold(ThresholdLevel::warningLow));
+    EXPECT_TRUE(state.alarm(ThresholdLevel::criticalLow));
+}
+
+TEST(SensorThresholdState, Deassertions)
+{
+    SensorThresholdState state;
+
+    // An alarm already set when the state is filled in was never seen
+    // asserting, so clearing it is not reported as a deassertion
+    state.updateAlarm("WarningAlarmLow", true, false);
+    state.updateAlarm("WarningAlarmLow", false, true);
+    EXPECT_FALSE(state.deasserted(ThresholdLevel::warningLow));
+
+    state.updateAlarm("CriticalAlarmHigh", true, true);
+    EXPECT_TRUE(state.alarm(ThresholdLevel::criticalHigh));
+    EXPECT_FALSE(state.deasserted(ThresholdLevel::criticalHigh));
+
+    state.updateAlarm("CriticalAlarmHigh", false, true);
+    EXPECT_TRUE(state.deasserted(ThresholdLevel::criticalHigh));
+
+    // Asserting again clears the deassertion
+    state.updateAlarm("CriticalAlarmHigh", true, true);
+    EXPECT_FALSE(state.deasserted(ThresholdLevel::criticalHigh));
+}
+
+TEST(SensorThresholdState, MaxMinIncludesThresholds)
+{
+    SensorThresholdState state;
+    state.maxValue = 100;
+    state.minValue = 0;
+
+    double max = 0;
+    double min = 0;
+    state.getMaxMin(max, min);
+    EXPECT_EQ(max, 100);
+    EXPECT_EQ(min, 0);
+
+    state.updateThreshold("CriticalHigh", 110);
+    state.updateThreshold("WarningHigh", 90);
+    state.updateThreshold("WarningLow", -5);
+    state.getMaxMin(max, min);
+    EXPECT_EQ(max, 110);
+    EXPECT_EQ(min, -5);
+}
+
+TEST(SensorThresholdState, VrProfile)
+{
+    SensorThresholdState state;
+    state.vrProfiles = {"Normal", "Turbo", "Eco"};
+
+    state.vrSelected = "Turbo";
+    EXPECT_EQ(state.vrProfileIndex(), 1);
+
+    state.vrSelected = "Unknown";
+    EXPECT_FALSE(state.vrProfileIndex());
+}
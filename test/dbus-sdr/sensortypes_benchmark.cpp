@@ -0,0 +1,105 @@
+#include "dbus-sdr/sensorindex.hpp"
+#include "dbus-sdr/sensortypes.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+// The per sensor classification on the handler hot path, parsed from the
+// path on every request as before, and read from the sensor index entry.
+// Run by 'make benchmarks', sensorindex_unittest checks both agree.
+
+struct SensorTypesBench
+{
+    SensorTypesBench()
+    {
+        static constexpr const char* types[] = {"temperature", "voltage",
+                                                "current",     "fan_tach",
+                                                "power",       "memory"};
+        for (size_t n = 0; n < 300; n++)
+        {
+            paths.emplace_back("/xyz/openbmc_project/sensors/" +
+                               std::string(types[n % 6]) + "/CPU" +
+                               std::to_string(n % 2) + "_Input_Sensor_" +
+                               std::to_string(n));
+        }
+        index.reserve(paths.size());
+        for (const auto& path : paths)
+        {
+            index.append(path, "service", {});
+        }
+    }
+
+    std::vector<std::string> paths;
+    SensorIndex index;
+};
+
+static const SensorTypesBench& bench()
+{
+    static const SensorTypesBench instance;
+    return instance;
+}
+
+// The check made by every reading, event status and event enable
+static void EventTypeFromPath(benchmark::State& state)
+{
+    const SensorTypesBench& b = bench();
+    for (auto _ : state)
+    {
+        for (const auto& path : b.paths)
+        {
+            benchmark::DoNotOptimize(getSensorEventTypeFromPath(path));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * b.paths.size());
+}
+BENCHMARK(EventTypeFromPath);
+
+static void EventTypeFromEntry(benchmark::State& state)
+{
+    const SensorTypesBench& b = bench();
+    for (auto _ : state)
+    {
+        for (size_t n = 0; n < b.index.size(); n++)
+        {
+            benchmark::DoNotOptimize(b.index.record(n)->eventType);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * b.index.size());
+}
+BENCHMARK(EventTypeFromEntry);
+
+// Sensor type, event type and name of a full sensor record
+static void SdrFieldsFromPath(benchmark::State& state)
+{
+    const SensorTypesBench& b = bench();
+    for (auto _ : state)
+    {
+        for (const auto& path : b.paths)
+        {
+            benchmark::DoNotOptimize(getSensorTypeFromPath(path));
+            benchmark::DoNotOptimize(getSensorEventTypeFromPath(path));
+            benchmark::DoNotOptimize(ipmi::sensor::parseSdrIdFromPath(path));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * b.paths.size());
+}
+BENCHMARK(SdrFieldsFromPath);
+
+static void SdrFieldsFromEntry(benchmark::State& state)
+{
+    const SensorTypesBench& b = bench();
+    for (auto _ : state)
+    {
+        for (size_t n = 0; n < b.index.size(); n++)
+        {
+            const SensorIndexEntry* entry = b.index.record(n);
+            benchmark::DoNotOptimize(entry->sensorType);
+            benchmark::DoNotOptimize(entry->eventType);
+            benchmark::DoNotOptimize(entry->sdrId.size());
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * b.index.size());
+}
+BENCHMARK(SdrFieldsFromEntry);
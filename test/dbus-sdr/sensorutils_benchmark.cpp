@@ -0,0 +1,87 @@
+#include "dbus-sdr/sensorutils.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <vector>
+
+// The linearization helpers over a sensor population shaped like a typical
+// two socket server. Run by 'make benchmarks', the cached results are
+// checked against the solved ones by sensorcommands_unittest.
+
+struct BenchSensor
+{
+    double min;
+    double max;
+    double value;
+};
+
+static const std::vector<BenchSensor>& population()
+{
+    static const std::vector<BenchSensor> sensors = []() {
+        std::vector<BenchSensor> sensors;
+        // Temperatures
+        for (size_t n = 0; n < 60; n++)
+        {
+            sensors.push_back({-128, 127, 30.0 + n});
+        }
+        // Voltages
+        for (size_t n = 0; n < 80; n++)
+        {
+            sensors.push_back({0, 3.3 + (n % 4) * 3, 1.0 + (n % 10) * 0.1});
+        }
+        // Fans
+        for (size_t n = 0; n < 40; n++)
+        {
+            sensors.push_back({0, 25000, 4000.0 + n * 100});
+        }
+        // Power and current
+        for (size_t n = 0; n < 40; n++)
+        {
+            sensors.push_back({0, 3000, 150.0 + n * 10});
+            sensors.push_back({0, 250, 12.5 + n});
+        }
+        return sensors;
+    }();
+    return sensors;
+}
+
+static void ReadingSolveEachTime(benchmark::State& state)
+{
+    const std::vector<BenchSensor>& sensors = population();
+    for (auto _ : state)
+    {
+        for (const auto& sensor : sensors)
+        {
+            int16_t mValue;
+            int8_t rExp;
+            int16_t bValue;
+            int8_t bExp;
+            bool bSigned;
+            ipmi::getSensorAttributes(sensor.max, sensor.min, mValue, rExp,
+                                      bValue, bExp, bSigned);
+            benchmark::DoNotOptimize(ipmi::scaleIPMIValueFromDouble(
+                sensor.value, mValue, rExp, bValue, bExp, bSigned));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sensors.size());
+}
+BENCHMARK(ReadingSolveEachTime);
+
+static void ReadingCachedAttributes(benchmark::State& state)
+{
+    const std::vector<BenchSensor>& sensors = population();
+    std::vector<ipmi::SensorAttributesCache> caches(sensors.size());
+    for (auto _ : state)
+    {
+        for (size_t i = 0; i < sensors.size(); i++)
+        {
+            const ipmi::SensorAttributes* attributes =
+                caches[i].get(sensors[i].max, sensors[i].min);
+            benchmark::DoNotOptimize(ipmi::scaleIPMIValueFromDouble(
+                sensors[i].value, attributes->mValue, attributes->rExp,
+                attributes->bValue, attributes->bExp, attributes->bSigned));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * sensors.size());
+}
+BENCHMARK(ReadingCachedAttributes);
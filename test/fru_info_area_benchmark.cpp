@@ -0,0 +1,66 @@
+#include "ipmi_fru_info_area.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <string>
+
+// Rebuild cost of the FRU area data for a fully populated FRU after a
+// change to one product field, from scratch and for the changed area only.
+// Run by 'make benchmarks', the builder itself is checked by
+// fru_info_area_unittest.
+
+using ipmi::fru::buildFruAreaData;
+using ipmi::fru::FruAreaBuilder;
+using ipmi::fru::FruAreaData;
+using ipmi::fru::FruInventoryData;
+
+static FruInventoryData makeInventory()
+{
+    // Every field of each area set, the longer ones past the field length
+    return {{"Chassis",
+             {{"Type", "23"},
+              {"Model Number", "0x4c2d43484153534953"},
+              {"Serial Number", "CHS0123456789"}}},
+            {"Board",
+             {{"Mfg Date", "2017-02-24 - 13:59:00"},
+              {"Manufacturer", "Example Manufacturing Corporation"},
+              {"Name", "System Board With A Rather Long Descriptive Name "
+                       "That Is Trimmed"},
+              {"Serial Number", "BRD0123456789ABCDEF"},
+              {"Part Number", "0x01D0A1B2C3"}}},
+            {"Product",
+             {{"Manufacturer", "Example Manufacturing Corporation"},
+              {"Name", "Example Server"},
+              {"Model Number", "ES-2200-XL"},
+              {"Version", "Rev C"},
+              {"Serial Number", "PRD0123456789"}}}};
+}
+
+static void RebuildFull(benchmark::State& state)
+{
+    FruInventoryData inventory = makeInventory();
+    size_t round = 0;
+    for (auto _ : state)
+    {
+        inventory["Product"]["Version"] = "Rev " + std::to_string(round++);
+        FruAreaData data = buildFruAreaData(inventory);
+        benchmark::DoNotOptimize(data.data());
+    }
+}
+BENCHMARK(RebuildFull);
+
+static void RebuildProductOnly(benchmark::State& state)
+{
+    FruInventoryData inventory = makeInventory();
+    FruAreaBuilder builder;
+    builder.build(inventory);
+    size_t round = 0;
+    for (auto _ : state)
+    {
+        inventory["Product"]["Version"] = "Rev " + std::to_string(round++);
+        builder.invalidate("Product");
+        FruAreaData data = builder.build(inventory);
+        benchmark::DoNotOptimize(data.data());
+    }
+}
+BENCHMARK(RebuildProductOnly);
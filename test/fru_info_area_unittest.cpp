@@ -0,0 +1,72 @@
+#include "ipmi_fru_info_area.hpp"
+
+#include <string>
+
+#include "gtest/gtest.h"
+
+using ipmi::fru::buildFruAreaData;
+using ipmi::fru::FruAreaBuilder;
+using ipmi::fru::FruAreaData;
+using ipmi::fru::FruInventoryData;
+
+static FruInventoryData makeInventory()
+{
+    // Every field of each area set, the longer ones past the field length
+    return {{"Chassis",
+             {{"Type", "23"},
+              {"Model Number", "0x4c2d43484153534953"},
+              {"Serial Number", "CHS0123456789"}}},
+            {"Board",
+             {{"Mfg Date", "2017-02-24 - 13:59:00"},
+              {"Manufacturer", "Example Manufacturing Corporation"},
+              {"Name", "System Board With A Rather Long Descriptive Name "
+                       "That Is Trimmed"},
+              {"Serial Number", "BRD0123456789ABCDEF"},
+              {"Part Number", "0x01D0A1B2C3"}}},
+            {"Product",
+             {{"Manufacturer", "Example Manufacturing Corporation"},
+              {"Name", "Example Server"},
+              {"Model Number", "ES-2200-XL"},
+              {"Version", "Rev C"},
+              {"Serial Number", "PRD0123456789"}}}};
+}
+
+TEST(FruAreaBuilder, MatchesFullBuild)
+{
+    FruInventoryData inventory = makeInventory();
+    FruAreaBuilder builder;
+    EXPECT_EQ(builder.build(inventory), buildFruAreaData(inventory));
+
+    // Built again from the cached areas
+    EXPECT_EQ(builder.build(inventory), buildFruAreaData(inventory));
+}
+
+TEST(FruAreaBuilder, RebuildsChangedArea)
+{
+    FruInventoryData inventory = makeInventory();
+    FruAreaBuilder builder;
+    builder.build(inventory);
+
+    for (size_t round = 0; round < 3; round++)
+    {
+        inventory["Product"]["Version"] = "Rev " + std::to_string(round);
+        builder.invalidate("Product");
+        EXPECT_EQ(builder.build(inventory), buildFruAreaData(inventory));
+    }
+}
+
+TEST(FruAreaBuilder, AreaSizeChange)
+{
+    // A longer field moves the areas after it, and the header offsets
+    FruInventoryData inventory = makeInventory();
+    FruAreaBuilder builder;
+    builder.build(inventory);
+
+    inventory["Board"]["Manufacturer"] = "A";
+    builder.invalidate("Board");
+    EXPECT_EQ(builder.build(inventory), buildFruAreaData(inventory));
+
+    inventory.erase("Chassis");
+    builder.invalidate("Chassis");
+    EXPECT_EQ(builder.build(inventory), buildFruAreaData(inventory));
+}
@@ -0,0 +1,89 @@
+#include "host-event-buffer.hpp"
+
+#include "gtest/gtest.h"
+
+using phosphor::host::event::Buffer;
+using phosphor::host::event::Message;
+
+static Message message(uint8_t id)
+{
+    Message data;
+    data.fill(0);
+    data[0] = id;
+    data[2] = 0x02;
+    return data;
+}
+
+TEST(HostEventBuffer, DisabledByDefault)
+{
+    int alerts = 0;
+    Buffer buffer([&alerts]() { alerts++; }, 4);
+
+    EXPECT_FALSE(buffer.enabled());
+    EXPECT_TRUE(buffer.systemEventLogging());
+    EXPECT_FALSE(buffer.push(message(1)));
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(buffer.dropped(), 0);
+    EXPECT_EQ(alerts, 0);
+}
+
+TEST(HostEventBuffer, DrainsInOrderWithOneAlert)
+{
+    int alerts = 0;
+    Buffer buffer([&alerts]() { alerts++; }, 4);
+    buffer.setEnabled(true);
+    buffer.setFullInterruptEnabled(true);
+
+    EXPECT_TRUE(buffer.push(message(1)));
+    EXPECT_TRUE(buffer.push(message(2)));
+    EXPECT_TRUE(buffer.push(message(3)));
+    EXPECT_EQ(alerts, 1);
+    EXPECT_EQ(buffer.size(), 3);
+
+    EXPECT_EQ(buffer.pop(), message(1));
+    EXPECT_EQ(buffer.pop(), message(2));
+    EXPECT_EQ(buffer.pop(), message(3));
+    EXPECT_EQ(buffer.pop(), std::nullopt);
+
+    // The next burst alerts the host again
+    EXPECT_TRUE(buffer.push(message(4)));
+    EXPECT_EQ(alerts, 2);
+}
+
+TEST(HostEventBuffer, DropsWhenFull)
+{
+    Buffer buffer(nullptr, 2);
+    buffer.setEnabled(true);
+
+    EXPECT_TRUE(buffer.push(message(1)));
+    EXPECT_TRUE(buffer.push(message(2)));
+    EXPECT_FALSE(buffer.push(message(3)));
+    EXPECT_EQ(buffer.dropped(), 1);
+    EXPECT_EQ(buffer.pop(), message(1));
+    EXPECT_TRUE(buffer.push(message(4)));
+    EXPECT_EQ(buffer.pop(), message(2));
+    EXPECT_EQ(buffer.pop(), message(4));
+}
+
+TEST(HostEventBuffer, Enables)
+{
+    int alerts = 0;
+    Buffer buffer([&alerts]() { alerts++; }, 4);
+    buffer.setEnabled(true);
+
+    // Without the interrupt the host finds the events by polling
+    EXPECT_TRUE(buffer.push(message(1)));
+    EXPECT_EQ(alerts, 0);
+    buffer.setFullInterruptEnabled(true);
+    EXPECT_EQ(alerts, 1);
+    buffer.setFullInterruptEnabled(true);
+    EXPECT_EQ(alerts, 1);
+    EXPECT_TRUE(buffer.fullInterruptEnabled());
+
+    buffer.setEnabled(false);
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_FALSE(buffer.push(message(2)));
+
+    buffer.setSystemEventLogging(false);
+    EXPECT_FALSE(buffer.systemEventLogging());
+}
@@ -256,6 +256,26 @@ TEST(PackBasics, StringViewUnaligned)
     EXPECT_EQ(p.raw, std::vector<uint8_t>({0b1}));
 }
 
+TEST(PackBasics, SharedBytes)
+{
+    ipmi::message::Payload p;
+    auto buffer = std::make_shared<const std::vector<uint8_t>>(
+        std::vector<uint8_t>{0x01, 0x24, 0x30, 0x11, 0x02});
+    ipmi::SharedBytes bytes(buffer, 1, 3);
+    buffer.reset();
+    EXPECT_EQ(p.pack(bytes), 0);
+    EXPECT_EQ(p.raw, std::vector<uint8_t>({0x24, 0x30, 0x11}));
+}
+
+TEST(PackBasics, SharedBytesUnaligned)
+{
+    ipmi::message::Payload p;
+    auto buffer = std::make_shared<const std::vector<uint8_t>>(
+        std::vector<uint8_t>{0x24, 0x30});
+    EXPECT_EQ(p.pack(true, ipmi::SharedBytes(buffer, 0, 2)), 1);
+    EXPECT_EQ(p.raw, std::vector<uint8_t>({0b1}));
+}
+
 TEST(PackBasics, OptionalEmpty)
 {
     // an optional will only pack if the value is present
@@ -0,0 +1,141 @@
+#include "selqueue.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <stdexcept>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+using ipmi::sel::SELQueue;
+
+// Records the writes started, completing them when the test says so
+struct Writer
+{
+    SELQueue::Write write(int id)
+    {
+        return [this, id](SELQueue::Done done) {
+            started.push_back(id);
+            dones.push_back(std::move(done));
+        };
+    }
+
+    std::vector<int> started;
+    std::vector<SELQueue::Done> dones;
+};
+
+// Run the handlers that are ready, as one turn of ipmid's io_context
+static void poll(boost::asio::io_context& io)
+{
+    io.restart();
+    io.poll();
+}
+
+TEST(SELQueue, WritesInOrderFromTheIoContext)
+{
+    boost::asio::io_context io;
+    SELQueue queue(io, 8, 4);
+    Writer writer;
+
+    EXPECT_TRUE(queue.push(writer.write(1)));
+    EXPECT_TRUE(queue.push(writer.write(2)));
+    // Nothing is written before the handler returns to the io_context
+    EXPECT_TRUE(writer.started.empty());
+    EXPECT_EQ(queue.depth(), 2);
+
+    poll(io);
+    EXPECT_EQ(writer.started, (std::vector<int>{1, 2}));
+    EXPECT_EQ(queue.depth(), 2);
+
+    writer.dones[0](true);
+    writer.dones[1](false);
+    EXPECT_EQ(queue.depth(), 0);
+    EXPECT_EQ(queue.written(), 1);
+    EXPECT_EQ(queue.failed(), 1);
+    EXPECT_EQ(queue.highWater(), 2);
+}
+
+TEST(SELQueue, LimitsOutstandingWrites)
+{
+    boost::asio::io_context io;
+    SELQueue queue(io, 16, 2);
+    Writer writer;
+
+    for (int id = 1; id <= 5; id++)
+    {
+        EXPECT_TRUE(queue.push(writer.write(id)));
+    }
+    poll(io);
+    EXPECT_EQ(writer.started, (std::vector<int>{1, 2}));
+
+    writer.dones[0](true);
+    poll(io);
+    EXPECT_EQ(writer.started, (std::vector<int>{1, 2, 3}));
+
+    writer.dones[1](true);
+    writer.dones[2](true);
+    poll(io);
+    EXPECT_EQ(writer.started, (std::vector<int>{1, 2, 3, 4, 5}));
+    writer.dones[3](true);
+    writer.dones[4](true);
+    EXPECT_EQ(queue.depth(), 0);
+    EXPECT_EQ(queue.written(), 5);
+}
+
+TEST(SELQueue, BusyWhenFull)
+{
+    boost::asio::io_context io;
+    SELQueue queue(io, 3, 2);
+    Writer writer;
+
+    EXPECT_TRUE(queue.push(writer.write(1)));
+    EXPECT_TRUE(queue.push(writer.write(2)));
+    EXPECT_TRUE(queue.push(writer.write(3)));
+    EXPECT_FALSE(queue.push(writer.write(4)));
+    EXPECT_EQ(queue.dropped(), 1);
+
+    // Outstanding writes still count against the capacity
+    poll(io);
+    EXPECT_FALSE(queue.push(writer.write(5)));
+    writer.dones[0](true);
+    EXPECT_TRUE(queue.push(writer.write(6)));
+    poll(io);
+    EXPECT_EQ(writer.started, (std::vector<int>{1, 2, 3}));
+    writer.dones[1](true);
+    poll(io);
+    EXPECT_EQ(writer.started, (std::vector<int>{1, 2, 3, 6}));
+    EXPECT_EQ(queue.dropped(), 2);
+    EXPECT_EQ(queue.highWater(), 3);
+    EXPECT_EQ(queue.capacity(), 3);
+}
+
+TEST(SELQueue, InlineWritesRunInBatches)
+{
+    boost::asio::io_context io;
+    SELQueue queue(io, 16, 4);
+    int count = 0;
+    for (int id = 0; id < 10; id++)
+    {
+        queue.push([&count](SELQueue::Done done) {
+            count++;
+            done(true);
+        });
+    }
+
+    EXPECT_EQ(io.run_one(), 1);
+    EXPECT_EQ(count, 4);
+    io.restart();
+    io.run();
+    EXPECT_EQ(count, 10);
+    EXPECT_EQ(queue.written(), 10);
+    EXPECT_EQ(queue.depth(), 0);
+}
+
+TEST(SELQueue, ThrowingWriteFails)
+{
+    boost::asio::io_context io;
+    SELQueue queue(io);
+    queue.push([](SELQueue::Done) { throw std::runtime_error("no logger"); });
+    io.run();
+    EXPECT_EQ(queue.failed(), 1);
+    EXPECT_EQ(queue.depth(), 0);
+}